@@ -1,4 +1,17 @@
 #pragma once
 #include "types.h"
 
+// Integrals over the enclosed region, winding-weighted like the shoelace sum and
+// oriented so that area is positive. Second moments are taken about the centroid.
+typedef struct Moments {
+    double area;
+    double signed_area;     // area before orienting: negative for a clockwise chain
+    double mx, my;          // first moments: integral of x and of y
+    Point centroid;
+    double ixx, iyy, ixy;   // integral of x^2, y^2 and xy relative to the centroid
+} Moments;
+
 double calculate_area(Point points[], int steps, double* approximation_error);
+double calculate_area_precision(Point points[], int steps, Precision precision, double* approximation_error);
+void segment_moments(const Segment segments[], int count, Moments* moments);
+void calculate_moments(const Point points[], Moments* moments);
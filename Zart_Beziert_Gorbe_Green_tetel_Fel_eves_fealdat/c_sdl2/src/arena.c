@@ -0,0 +1,148 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ArenaOverflow {
+    ArenaOverflow* next;
+    size_t size;
+};
+
+#define OVERFLOW_HEADER ((sizeof(ArenaOverflow) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+// One scratch arena per thread, created on first use
+static _Thread_local Arena thread_scratch;
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static void* aligned_block(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, ARENA_ALIGNMENT);
+#else
+    return aligned_alloc(ARENA_ALIGNMENT, align_up(size));
+#endif
+}
+
+static void free_aligned_block(void* block) {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    free(block);
+#endif
+}
+
+bool arena_init(Arena* arena, size_t capacity) {
+    memset(arena, 0, sizeof(*arena));
+    arena->capacity = align_up(capacity);
+    arena->base = aligned_block(arena->capacity);
+    if (arena->base == NULL) {
+        arena->capacity = 0;
+        return false;
+    }
+    return true;
+}
+
+static void free_overflow(Arena* arena) {
+    while (arena->overflow != NULL) {
+        ArenaOverflow* next = arena->overflow->next;
+        free_aligned_block(arena->overflow);
+        arena->overflow = next;
+    }
+    arena->overflow_bytes = 0;
+}
+
+void arena_free(Arena* arena) {
+    free_overflow(arena);
+    free_aligned_block(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = align_up(size > 0 ? size : 1);
+    void* block;
+    if (arena->used + size <= arena->capacity) {
+        block = arena->base + arena->used;
+        arena->used += size;
+    } else {
+        ArenaOverflow* overflow = aligned_block(OVERFLOW_HEADER + size);
+        if (overflow == NULL) {
+            return NULL;
+        }
+        overflow->next = arena->overflow;
+        overflow->size = size;
+        arena->overflow = overflow;
+        arena->overflow_bytes += size;
+        ++arena->overflow_count;
+        block = (unsigned char*)overflow + OVERFLOW_HEADER;
+    }
+    if (arena->used + arena->overflow_bytes > arena->peak) {
+        arena->peak = arena->used + arena->overflow_bytes;
+    }
+    return block;
+}
+
+// Grows in place when block is the most recent bump allocation, otherwise copies
+void* arena_realloc(Arena* arena, void* block, size_t old_size, size_t new_size) {
+    if (block != NULL && (unsigned char*)block + align_up(old_size) == arena->base + arena->used &&
+        (unsigned char*)block - arena->base + align_up(new_size) <= arena->capacity) {
+        arena->used = (unsigned char*)block - arena->base + align_up(new_size);
+        if (arena->used + arena->overflow_bytes > arena->peak) {
+            arena->peak = arena->used + arena->overflow_bytes;
+        }
+        return block;
+    }
+    void* grown = arena_alloc(arena, new_size);
+    if (grown != NULL && block != NULL) {
+        memcpy(grown, block, old_size < new_size ? old_size : new_size);
+    }
+    return grown;
+}
+
+size_t arena_mark(const Arena* arena) {
+    return arena->used;
+}
+
+// Overflow blocks stay until the next reset; only the bump pointer moves back
+void arena_release(Arena* arena, size_t mark) {
+    if (mark <= arena->used) {
+        arena->used = mark;
+    }
+}
+
+void arena_reset(Arena* arena) {
+    bool overflowed = arena->overflow != NULL;
+    free_overflow(arena);
+    arena->used = 0;
+    ++arena->resets;
+    if (overflowed && arena->peak > arena->capacity) {
+        // Nothing points into the arena after a reset, so the block can move
+        size_t capacity = align_up(arena->peak + arena->peak / 4);
+        unsigned char* base = aligned_block(capacity);
+        if (base != NULL) {
+            free_aligned_block(arena->base);
+            arena->base = base;
+            arena->capacity = capacity;
+        }
+    }
+}
+
+Arena* scratch_arena(void) {
+    if (thread_scratch.base == NULL) {
+        arena_init(&thread_scratch, ARENA_DEFAULT_CAPACITY);
+    }
+    return &thread_scratch;
+}
+
+void scratch_arena_shutdown(void) {
+    arena_free(&thread_scratch);
+}
+
+void arena_print_stats(const Arena* arena, const char* label) {
+    printf("%s: kapacitas %.1f KB, csucs %.1f KB, malloc tulcsordulas %ld, nullazas %ld\n", label,
+           arena->capacity / 1024.0, arena->peak / 1024.0, arena->overflow_count, arena->resets);
+}
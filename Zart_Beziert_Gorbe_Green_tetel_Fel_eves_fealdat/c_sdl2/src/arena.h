@@ -0,0 +1,34 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bump allocator for per-frame and per-job scratch memory. Routines take a mark on entry
+// and release back to it on exit; the owner resets once per frame or job. Requests that
+// do not fit are served by malloc until the next reset, which then grows the block to
+// the observed peak, so the steady state never touches the heap.
+#define ARENA_ALIGNMENT 16
+#define ARENA_DEFAULT_CAPACITY (1u << 20)
+
+typedef struct ArenaOverflow ArenaOverflow;
+
+typedef struct Arena {
+    unsigned char* base;
+    size_t capacity;
+    size_t used;
+    size_t peak;                // largest used + overflow bytes since init
+    size_t overflow_bytes;      // served by malloc since the last reset
+    ArenaOverflow* overflow;
+    long overflow_count;        // all malloc fallbacks since init
+    long resets;
+} Arena;
+
+bool arena_init(Arena* arena, size_t capacity);
+void arena_free(Arena* arena);
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_realloc(Arena* arena, void* block, size_t old_size, size_t new_size);
+size_t arena_mark(const Arena* arena);
+void arena_release(Arena* arena, size_t mark);
+void arena_reset(Arena* arena);
+Arena* scratch_arena(void);
+void scratch_arena_shutdown(void);
+void arena_print_stats(const Arena* arena, const char* label);
@@ -0,0 +1,612 @@
+#include "bench.h"
+#include "bezier_degree.h"
+#include "intersect.h"
+#include "query.h"
+#include "bezier.h"
+#include "area.h"
+#include "arena.h"
+#include "simplify.h"
+#include "stream.h"
+#include "conic.h"
+#include "offset.h"
+#include "power_basis.h"
+#include "utils.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_SAMPLES 200000
+#define BENCH_MAX_DEGREE 10
+#define BENCH_MAX_INTERSECTIONS 4096
+#define BENCH_QUERIES 1000000
+#define BENCH_NEAREST_CHECKS 2000
+#define BENCH_REFERENCE_STEPS 64
+#define BENCH_PRECISION_CURVES 2000
+#define BENCH_PRECISION_STEPS 1000
+#define BENCH_SIMPLIFY_SEGMENTS 400
+#define BENCH_SIMPLIFY_STEPS 16
+#define BENCH_REDUCE_CURVES 200
+#define BENCH_CONIC_ELLIPSES 20000
+#define BENCH_CONIC_STEPS 100
+#define BENCH_STROKES 2000
+#define BENCH_POWER_SEGMENTS 400
+#define BENCH_POWER_STEPS 64
+#define BENCH_POWER_FRAMES 200
+
+static volatile double bench_sink;
+
+static double elapsed_ns(Uint64 start, int evaluations) {
+    return (SDL_GetPerformanceCounter() - start) * 1e9 / (double)SDL_GetPerformanceFrequency() / evaluations;
+}
+
+// Runtime-degree baselines, as in geometria/Casteljau.c and geometria/Racionalis_Bezier_gorbe.c
+static Point de_casteljau_reference(const Point points[], int n, double t) {
+    Point new_points[BENCH_MAX_DEGREE + 1];
+    for (int i = 0; i < n; ++i) {
+        new_points[i] = points[i];
+    }
+    for (int k = 1; k < n; ++k) {
+        for (int i = 0; i < n - k; ++i) {
+            new_points[i].x = (1 - t) * new_points[i].x + t * new_points[i + 1].x;
+            new_points[i].y = (1 - t) * new_points[i].y + t * new_points[i + 1].y;
+        }
+    }
+    return new_points[0];
+}
+
+static int factorial_reference(int n) {
+    int result = 1;
+    for (int i = 2; i <= n; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+static Point rational_reference(const Point points[], const double weights[], int n, double t) {
+    double num_x = 0.0, num_y = 0.0, denom = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double b = (factorial_reference(n - 1) / (factorial_reference(i) * factorial_reference(n - 1 - i)))
+                   * pow(t, i) * pow(1 - t, n - 1 - i);
+        num_x += weights[i] * b * points[i].x;
+        num_y += weights[i] * b * points[i].y;
+        denom += weights[i] * b;
+    }
+    Point result = { num_x / denom, num_y / denom };
+    return result;
+}
+
+static void bench_degree_specialization(void) {
+    static double params[BENCH_SAMPLES];
+    static Point out[BENCH_SAMPLES];
+    Point control[BENCH_MAX_DEGREE + 1];
+    double weights[BENCH_MAX_DEGREE + 1];
+    for (int i = 0; i <= BENCH_MAX_DEGREE; ++i) {
+        control[i].x = 200 + 400 * cos(i * 0.9);
+        control[i].y = 300 + 250 * sin(i * 1.7);
+        weights[i] = 0.5 + (i % 3) * 0.75;
+    }
+    for (int k = 0; k < BENCH_SAMPLES; ++k) {
+        params[k] = (double)k / (BENCH_SAMPLES - 1);
+    }
+
+    printf("Fokszam  deCasteljau  Horner(n)  bezier_eval  batch   gyorsulas | racionalis ref  batch   gyorsulas | max elteres\n");
+    for (int degree = 1; degree <= BENCH_MAX_DEGREE; degree += (degree < BEZIER_MAX_UNROLLED_DEGREE ? 1 : 3)) {
+        double max_error = 0.0;
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < BENCH_SAMPLES; ++k) {
+            out[k] = de_casteljau_reference(control, degree + 1, params[k]);
+        }
+        double reference_ns = elapsed_ns(start, BENCH_SAMPLES);
+        for (int k = 0; k < BENCH_SAMPLES; k += 97) {
+            Point fast = bezier_eval(control, degree, params[k]);
+            double error = fabs(fast.x - out[k].x) + fabs(fast.y - out[k].y);
+            max_error = error > max_error ? error : max_error;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < BENCH_SAMPLES; ++k) {
+            out[k] = bezier_eval_runtime(control, degree, params[k]);
+        }
+        double runtime_ns = elapsed_ns(start, BENCH_SAMPLES);
+        bench_sink = out[BENCH_SAMPLES / 3].x;
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < BENCH_SAMPLES; ++k) {
+            out[k] = bezier_eval(control, degree, params[k]);
+        }
+        double single_ns = elapsed_ns(start, BENCH_SAMPLES);
+        bench_sink = out[BENCH_SAMPLES / 3].x;
+
+        start = SDL_GetPerformanceCounter();
+        bezier_eval_batch(control, degree, params, BENCH_SAMPLES, out);
+        double batch_ns = elapsed_ns(start, BENCH_SAMPLES);
+        bench_sink = out[BENCH_SAMPLES / 3].x;
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < BENCH_SAMPLES; ++k) {
+            out[k] = rational_reference(control, weights, degree + 1, params[k]);
+        }
+        double rational_reference_ns = elapsed_ns(start, BENCH_SAMPLES);
+        for (int k = 0; k < BENCH_SAMPLES; k += 97) {
+            Point fast = rational_bezier_eval(control, weights, degree, params[k]);
+            double error = fabs(fast.x - out[k].x) + fabs(fast.y - out[k].y);
+            max_error = error > max_error ? error : max_error;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        rational_bezier_eval_batch(control, weights, degree, params, BENCH_SAMPLES, out);
+        double rational_batch_ns = elapsed_ns(start, BENCH_SAMPLES);
+        bench_sink = out[BENCH_SAMPLES / 3].x;
+
+        printf("%5d%s  %8.1f ns  %6.1f ns  %8.1f ns  %5.1f ns  %5.2fx  | %9.1f ns  %5.1f ns  %5.2fx  | %.2e\n",
+               degree, degree > BEZIER_MAX_UNROLLED_DEGREE ? "*" : " ",
+               reference_ns, runtime_ns, single_ns, batch_ns, reference_ns / batch_ns,
+               rational_reference_ns, rational_batch_ns, rational_reference_ns / rational_batch_ns, max_error);
+    }
+    printf("(* futasideju fokszam, nincs kibontott valtozat)\n");
+}
+
+// Closed wavy curve r(theta) = radius + amplitude * sin(waves * theta) as cubic Hermite pieces
+static void wavy_curve(Segment segments[], int count, Point center, double radius, double amplitude, int waves) {
+    double h = 2.0 * M_PI / count;
+    for (int i = 0; i < count; ++i) {
+        Point p[2], d[2];
+        for (int k = 0; k < 2; ++k) {
+            double theta = (i + k) * h;
+            double r = radius + amplitude * sin(waves * theta);
+            double dr = amplitude * waves * cos(waves * theta);
+            p[k].x = center.x + r * cos(theta);
+            p[k].y = center.y + r * sin(theta);
+            d[k].x = dr * cos(theta) - r * sin(theta);
+            d[k].y = dr * sin(theta) + r * cos(theta);
+        }
+        segments[i].p[0] = p[0];
+        segments[i].p[1].x = p[0].x + d[0].x * h / 3.0;
+        segments[i].p[1].y = p[0].y + d[0].y * h / 3.0;
+        segments[i].p[2].x = p[1].x - d[1].x * h / 3.0;
+        segments[i].p[2].y = p[1].y - d[1].y * h / 3.0;
+        segments[i].p[3] = p[1];
+    }
+}
+
+static void bench_intersections(void) {
+    static const int sizes[] = { 250, 1000, 4000 };
+    static Intersection hits[BENCH_MAX_INTERSECTIONS];
+    printf("\nSzegmens  metszes  sweep       brute force   gyorsulas  egyenes  onmetszes\n");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        int n = sizes[s];
+        Segment* a = malloc(n * sizeof(Segment));
+        Segment* b = malloc(n * sizeof(Segment));
+        if (a == NULL || b == NULL) {
+            free(a);
+            free(b);
+            return;
+        }
+        Point center_a = { 400, 300 }, center_b = { 430, 290 };
+        wavy_curve(a, n, center_a, 200, 12, n / 8);
+        wavy_curve(b, n, center_b, 200, 12, n / 8 + 3);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        int found = intersect_curves(a, n, b, n, hits, BENCH_MAX_INTERSECTIONS);
+        double sweep_ms = elapsed_ns(start, 1) * 1e-6;
+
+        start = SDL_GetPerformanceCounter();
+        int reference = intersect_curves_brute_force(a, n, b, n, hits, BENCH_MAX_INTERSECTIONS);
+        double brute_ms = elapsed_ns(start, 1) * 1e-6;
+
+        Point l0 = { 0, 300 }, l1 = { 800, 310 };
+        int line_hits = intersect_curve_line(a, n, l0, l1, hits, BENCH_MAX_INTERSECTIONS);
+        int self_hits = intersect_self(a, n, hits, BENCH_MAX_INTERSECTIONS);
+
+        printf("%8d  %7d  %8.2f ms  %9.2f ms  %8.1fx  %7d  %9d%s\n",
+               n, found, sweep_ms, brute_ms, brute_ms / sweep_ms, line_hits, self_hits,
+               found == reference ? "" : "  (elteres a brute force eredmenytol!)");
+        free(a);
+        free(b);
+    }
+}
+
+// Reference answers from dense bezier() sampling
+static int sampled_winding(const Point polyline[], int count, Point q) {
+    int winding = 0;
+    for (int i = 0; i < count; ++i) {
+        Point a = polyline[i], b = polyline[(i + 1) % count];
+        if ((a.y <= q.y) != (b.y <= q.y)) {
+            double x = a.x + (q.y - a.y) * (b.x - a.x) / (b.y - a.y);
+            if (x > q.x) {
+                winding += b.y > a.y ? 1 : -1;
+            }
+        }
+    }
+    return winding;
+}
+
+static double sampled_distance(const Point polyline[], int count, Point q) {
+    double best = INFINITY;
+    for (int i = 0; i < count; ++i) {
+        double dx = polyline[i].x - q.x, dy = polyline[i].y - q.y;
+        best = fmin(best, dx * dx + dy * dy);
+    }
+    return sqrt(best);
+}
+
+static void bench_queries(void) {
+    const int n = 2000;
+    const int dense_steps = 4096;
+    Segment* segments = malloc(n * sizeof(Segment));
+    Point* queries = malloc(BENCH_QUERIES * sizeof(Point));
+    int* winding = malloc(BENCH_QUERIES * sizeof(int));
+    NearestPoint* nearest = malloc(BENCH_NEAREST_CHECKS * sizeof(NearestPoint));
+    Point* polyline = malloc((size_t)n * (dense_steps + 1) * sizeof(Point));
+    CurveQuery query = { 0 };
+    if (segments == NULL || queries == NULL || winding == NULL || nearest == NULL || polyline == NULL) {
+        goto cleanup;
+    }
+    Point center = { 400, 300 };
+    wavy_curve(segments, n, center, 220, 15, 97);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!query_build(&query, segments, n)) {
+        goto cleanup;
+    }
+    double build_ms = elapsed_ns(start, 1) * 1e-6;
+
+    unsigned state = 12345u;
+    for (int i = 0; i < BENCH_QUERIES; ++i) {
+        queries[i].x = random_range(&state, 0.0, WINDOW_WIDTH);
+        queries[i].y = random_range(&state, 0.0, WINDOW_HEIGHT);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_QUERIES; ++i) {
+        winding[i] = query_winding(&query, queries[i]);
+    }
+    double single_ns = elapsed_ns(start, BENCH_QUERIES);
+    start = SDL_GetPerformanceCounter();
+    query_winding_batch(&query, queries, BENCH_QUERIES, winding);
+    double batch_ns = elapsed_ns(start, BENCH_QUERIES);
+
+    int reference_count = n * (BENCH_REFERENCE_STEPS + 1);
+    tessellate_segments(segments, n, BENCH_REFERENCE_STEPS, polyline);
+    start = SDL_GetPerformanceCounter();
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_NEAREST_CHECKS; ++i) {
+        mismatches += (sampled_winding(polyline, reference_count, queries[i]) != 0) != (winding[i] != 0);
+    }
+    double sampled_inside_ns = elapsed_ns(start, BENCH_NEAREST_CHECKS);
+
+    start = SDL_GetPerformanceCounter();
+    query_nearest_batch(&query, queries, BENCH_NEAREST_CHECKS, nearest);
+    double nearest_ns = elapsed_ns(start, BENCH_NEAREST_CHECKS);
+    int dense_count = tessellate_segments(segments, n, dense_steps, polyline);
+    start = SDL_GetPerformanceCounter();
+    double max_deviation = 0.0;
+    for (int i = 0; i < BENCH_NEAREST_CHECKS; ++i) {
+        double sampled = sampled_distance(polyline, dense_count, queries[i]);
+        max_deviation = fmax(max_deviation, nearest[i].distance - sampled);
+    }
+    double sampled_nearest_ns = elapsed_ns(start, BENCH_NEAREST_CHECKS);
+
+    printf("\nLekerdezes: %d szegmens, %d monoton darab, %d BVH csucs, epites %.2f ms\n",
+           n, query.piece_count, query.node_count, build_ms);
+    printf("Belul teszt:   %.0f ns/pont (1 szal), %.0f ns/pont (batch), mintavetelezve %.0f ns/pont, elteres: %d/%d\n",
+           single_ns, batch_ns, sampled_inside_ns, mismatches, BENCH_NEAREST_CHECKS);
+    printf("Legkozelebbi:  %.0f ns/pont (batch), mintavetelezve %.0f ns/pont, max tobblet tavolsag: %.2e\n",
+           nearest_ns, sampled_nearest_ns, max_deviation);
+
+cleanup:
+    query_free(&query);
+    free(segments);
+    free(queries);
+    free(winding);
+    free(nearest);
+    free(polyline);
+}
+
+// Float32 path against double on random curves inside the window. The double
+// tessellation is the cached power basis the scene draws from.
+static void bench_precision(void) {
+    static Point reference[N_POINTS * (BENCH_PRECISION_STEPS + 1)];
+    static PointF narrow[N_POINTS * (BENCH_PRECISION_STEPS + 1)];
+    PowerBasis basis = { 0 };
+    double max_deviation = 0.0, max_area_deviation = 0.0, max_area_difference = 0.0;
+    double double_ns = 0.0, float_ns = 0.0, area_double_ns = 0.0, area_float_ns = 0.0;
+    unsigned state = 4242u;
+    for (int c = 0; c < BENCH_PRECISION_CURVES; ++c) {
+        Point points[N_POINTS];
+        for (int i = 0; i < N_POINTS; ++i) {
+            points[i].x = random_range(&state, 0.0, WINDOW_WIDTH);
+            points[i].y = random_range(&state, 0.0, WINDOW_HEIGHT);
+        }
+        Segment segments[N_POINTS];
+        build_segments(points, N_POINTS, segments);
+        if (!power_basis_update(&basis, segments, N_POINTS)) {
+            break;
+        }
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        int count = power_basis_tessellate(&basis, BENCH_PRECISION_STEPS, reference);
+        double_ns += elapsed_ns(start, count);
+        start = SDL_GetPerformanceCounter();
+        tessellate_segments_f(segments, N_POINTS, BENCH_PRECISION_STEPS, narrow);
+        float_ns += elapsed_ns(start, count);
+        for (int i = 0; i < count; ++i) {
+            max_deviation = fmax(max_deviation, hypot(narrow[i].x - reference[i].x, narrow[i].y - reference[i].y));
+        }
+
+        double error;
+        start = SDL_GetPerformanceCounter();
+        double area = calculate_area_precision(points, BENCH_PRECISION_STEPS, PRECISION_DOUBLE, &error);
+        area_double_ns += elapsed_ns(start, count);
+        start = SDL_GetPerformanceCounter();
+        double area_f = calculate_area_precision(points, BENCH_PRECISION_STEPS, PRECISION_FLOAT, &error);
+        area_float_ns += elapsed_ns(start, count);
+        max_area_difference = fmax(max_area_difference, fabs(area_f - area));
+        if (area > 1.0) {
+            max_area_deviation = fmax(max_area_deviation, fabs(area_f - area) / area);
+        }
+        bench_sink = reference[count / 2].x + narrow[count / 3].y;
+    }
+    power_basis_free(&basis);
+    printf("\nPontossag (%d gorbe, %d lepes/szegmens)\n", BENCH_PRECISION_CURVES, BENCH_PRECISION_STEPS);
+    printf("Tesszellacio:  double %.2f ns/pont  float %.2f ns/pont  max elteres %.2e pixel\n",
+           double_ns / BENCH_PRECISION_CURVES, float_ns / BENCH_PRECISION_CURVES, max_deviation);
+    printf("Terulet:       double %.2f ns/pont  float %.2f ns/pont  max elteres %.2e pixel^2 (relativ %.2e)\n",
+           area_double_ns / BENCH_PRECISION_CURVES, area_float_ns / BENCH_PRECISION_CURVES,
+           max_area_difference, max_area_deviation);
+}
+
+// Refits a dense polyline of a wavy outline, and reduces random high-degree curves to cubics
+static void bench_simplify(void) {
+    static const double tolerances[] = { 0.05, 0.25, 1.0 };
+    static Segment segments[BENCH_SIMPLIFY_SEGMENTS];
+    static Point chain[3 * BENCH_SIMPLIFY_SEGMENTS];
+    static Point polyline[BENCH_SIMPLIFY_SEGMENTS * BENCH_SIMPLIFY_STEPS];
+    static Point fitted[3 * BENCH_SIMPLIFY_SEGMENTS * BENCH_SIMPLIFY_STEPS];
+    Point center = { 400, 300 };
+    wavy_curve(segments, BENCH_SIMPLIFY_SEGMENTS, center, 220, 25, 7);
+    for (int i = 0; i < BENCH_SIMPLIFY_SEGMENTS; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            chain[3 * i + k] = segments[i].p[k];
+        }
+        for (int k = 0; k < BENCH_SIMPLIFY_STEPS; ++k) {
+            Point* p = segments[i].p;
+            polyline[i * BENCH_SIMPLIFY_STEPS + k] = bezier(p[0], p[1], p[2], p[3], (double)k / BENCH_SIMPLIFY_STEPS);
+        }
+    }
+    int samples = BENCH_SIMPLIFY_SEGMENTS * BENCH_SIMPLIFY_STEPS;
+    double area = closed_curve_area(chain, BENCH_SIMPLIFY_SEGMENTS);
+
+    printf("\nEgyszerusites (%d szegmens, %d pontos tort vonal, terulet %.2f)\n", BENCH_SIMPLIFY_SEGMENTS, samples, area);
+    printf("Tolerancia  szegmens  max elteres  relativ teruletvaltozas  ido\n");
+    for (int i = 0; i < (int)(sizeof(tolerances) / sizeof(tolerances[0])); ++i) {
+        double error;
+        Uint64 start = SDL_GetPerformanceCounter();
+        int count = fit_closed_polyline(polyline, samples, tolerances[i], fitted, samples, &error);
+        double fit_ms = elapsed_ns(start, 1) * 1e-6;
+        double fitted_area = count > 0 ? closed_curve_area(fitted, count) : 0.0;
+        printf("  %6.2f    %6d      %.4f       %.2e              %.2f ms\n", tolerances[i], count, error,
+               fabs(fitted_area - area) / area, fit_ms);
+    }
+
+    static const int degrees[] = { 8, 12, 16 };
+    printf("Fokszam  kobos darab (atlag)  max elteres  ido/gorbe\n");
+    unsigned state = 777u;
+    for (int d = 0; d < (int)(sizeof(degrees) / sizeof(degrees[0])); ++d) {
+        int degree = degrees[d];
+        long pieces = 0;
+        double worst = 0.0, total_ns = 0.0;
+        for (int c = 0; c < BENCH_REDUCE_CURVES; ++c) {
+            Point control[BENCH_MAX_DEGREE * 2 + 1];
+            for (int k = 0; k <= degree; ++k) {
+                control[k].x = 100 + k * 600.0 / degree + random_range(&state, 0.0, 80.0);
+                control[k].y = 300 + random_range(&state, -150.0, 150.0);
+            }
+            double error;
+            Uint64 start = SDL_GetPerformanceCounter();
+            int count = reduce_degree(control, degree, 0.25, fitted, samples, &error);
+            total_ns += elapsed_ns(start, 1);
+            pieces += count;
+            worst = fmax(worst, error);
+        }
+        printf("   %2d          %5.2f           %.4f     %.1f us\n", degree, (double)pieces / BENCH_REDUCE_CURVES,
+               worst, total_ns / BENCH_REDUCE_CURVES * 1e-3);
+    }
+}
+
+// Exact ellipse area and perimeter against tessellating the same conic arcs
+static void bench_conics(void) {
+    double area_ns = 0.0, polygon_ns = 0.0, agm_ns = 0.0, carlson_ns = 0.0, gauss_ns = 0.0;
+    double area_error = 0.0, polygon_error = 0.0, carlson_error = 0.0, gauss_error = 0.0;
+    unsigned state = 99u;
+    for (int e = 0; e < BENCH_CONIC_ELLIPSES; ++e) {
+        double rx = random_range(&state, 5.0, 305.0);
+        double ry = random_range(&state, 5.0, 305.0);
+        double rotation = random_range(&state, 0.0, 2.0 * M_PI);
+        Point center = { 400, 300 };
+        double exact_area = M_PI * rx * ry;
+        Conic arcs[CONIC_MAX_ARC_PIECES];
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        int count = conic_ellipse(center, rx, ry, rotation, arcs);
+        double area = conic_chain_area(arcs, count);
+        area_ns += elapsed_ns(start, 1);
+        area_error = fmax(area_error, fabs(area - exact_area) / exact_area);
+
+        start = SDL_GetPerformanceCounter();
+        double polygon = 0.0;
+        for (int i = 0; i < count; ++i) {
+            Point a = arcs[i].p[0];
+            for (int k = 1; k <= BENCH_CONIC_STEPS; ++k) {
+                Point b = conic_eval(&arcs[i], (double)k / BENCH_CONIC_STEPS);
+                polygon += 0.5 * (a.x * b.y - b.x * a.y);
+                a = b;
+            }
+        }
+        polygon_ns += elapsed_ns(start, 1);
+        polygon_error = fmax(polygon_error, fabs(fabs(polygon) - exact_area) / exact_area);
+
+        start = SDL_GetPerformanceCounter();
+        double perimeter = ellipse_perimeter(rx, ry);
+        agm_ns += elapsed_ns(start, 1);
+        start = SDL_GetPerformanceCounter();
+        double carlson = ellipse_arc_length(rx, ry, 0.0, 2.0 * M_PI);
+        carlson_ns += elapsed_ns(start, 1);
+        start = SDL_GetPerformanceCounter();
+        double gauss = 0.0;
+        for (int i = 0; i < count; ++i) {
+            gauss += conic_length(&arcs[i]);
+        }
+        gauss_ns += elapsed_ns(start, 1);
+        carlson_error = fmax(carlson_error, fabs(carlson - perimeter) / perimeter);
+        gauss_error = fmax(gauss_error, fabs(gauss - perimeter) / perimeter);
+        bench_sink = area + polygon + perimeter + carlson + gauss;
+    }
+    printf("\nKupszeletek (%d ellipszis, 4 racionalis negyed iv)\n", BENCH_CONIC_ELLIPSES);
+    printf("Terulet:  Green zart alak %.0f ns  max relativ hiba %.2e | %d lepes/iv tort vonal %.0f ns  hiba %.2e\n",
+           area_ns / BENCH_CONIC_ELLIPSES, area_error, BENCH_CONIC_STEPS, polygon_ns / BENCH_CONIC_ELLIPSES, polygon_error);
+    printf("Kerulet:  AGM %.0f ns | Carlson %.0f ns  elteres %.2e | adaptiv Gauss %.0f ns  elteres %.2e\n",
+           agm_ns / BENCH_CONIC_ELLIPSES, carlson_ns / BENCH_CONIC_ELLIPSES, carlson_error,
+           gauss_ns / BENCH_CONIC_ELLIPSES, gauss_error);
+}
+
+// Stroke outlines of random curves: full rebuilds against cache hits
+static void bench_strokes(void) {
+    static const JoinStyle joins[3] = { JOIN_BEVEL, JOIN_MITER, JOIN_ROUND };
+    static const char* names[3] = { "tompa", "hegyes", "kerek" };
+    printf("\nVastag vonal (%d gorbe, fel szelesseg %.0f, tolerancia 0.1)\n", BENCH_STROKES, STROKE_HALF_WIDTH);
+    for (int j = 0; j < 3; ++j) {
+        Stroke stroke = { 0 };
+        double build_ns = 0.0, cached_ns = 0.0, band = 0.0;
+        long pieces = 0;
+        unsigned state = 31u;
+        for (int c = 0; c < BENCH_STROKES; ++c) {
+            Point points[N_POINTS];
+            for (int i = 0; i < N_POINTS; ++i) {
+                points[i].x = random_range(&state, 0.0, WINDOW_WIDTH);
+                points[i].y = random_range(&state, 0.0, WINDOW_HEIGHT);
+            }
+            Uint64 start = SDL_GetPerformanceCounter();
+            stroke_update(&stroke, points, STROKE_HALF_WIDTH, joins[j], 0.1);
+            build_ns += elapsed_ns(start, 1);
+            start = SDL_GetPerformanceCounter();
+            stroke_update(&stroke, points, STROKE_HALF_WIDTH, joins[j], 0.1);
+            cached_ns += elapsed_ns(start, 1);
+            pieces += stroke.counts[0] + stroke.counts[1];
+            band += stroke.band_area;
+        }
+        printf("%-7s epites %.1f us  gyorsitotarbol %.0f ns  %.1f darab/gorbe  atlagos sav terulet %.1f\n", names[j],
+               build_ns / BENCH_STROKES * 1e-3, cached_ns / BENCH_STROKES, (double)pieces / BENCH_STROKES,
+               band / BENCH_STROKES);
+        stroke_free(&stroke);
+    }
+}
+
+// Per-frame tessellation of a static curve: Bernstein form from the control points every
+// frame, against the cached power basis that is only checked for changes
+static void bench_power_basis(void) {
+    static Segment segments[BENCH_POWER_SEGMENTS];
+    static Point bernstein[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    static Point horner[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    wavy_curve(segments, BENCH_POWER_SEGMENTS, (Point){ 400, 300 }, 220, 25, 11);
+    PowerBasis basis = { 0 };
+    double bernstein_ns = 0.0, horner_ns = 0.0, area_ns = 0.0, moments_ns = 0.0;
+    int count = 0;
+    for (int frame = 0; frame < BENCH_POWER_FRAMES; ++frame) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        count = tessellate_segments(segments, BENCH_POWER_SEGMENTS, BENCH_POWER_STEPS, bernstein);
+        bernstein_ns += elapsed_ns(start, count);
+        start = SDL_GetPerformanceCounter();
+        power_basis_update(&basis, segments, BENCH_POWER_SEGMENTS);
+        power_basis_tessellate(&basis, BENCH_POWER_STEPS, horner);
+        horner_ns += elapsed_ns(start, count);
+        start = SDL_GetPerformanceCounter();
+        bench_sink = power_basis_area(&basis);
+        area_ns += elapsed_ns(start, BENCH_POWER_SEGMENTS);
+        Moments moments;
+        start = SDL_GetPerformanceCounter();
+        segment_moments(segments, BENCH_POWER_SEGMENTS, &moments);
+        moments_ns += elapsed_ns(start, BENCH_POWER_SEGMENTS);
+    }
+    double max_deviation = 0.0;
+    for (int i = 0; i < count; ++i) {
+        max_deviation = fmax(max_deviation, hypot(horner[i].x - bernstein[i].x, horner[i].y - bernstein[i].y));
+    }
+    Moments moments;
+    segment_moments(segments, BENCH_POWER_SEGMENTS, &moments);
+    printf("\nHatvanybazis (%d szegmens, %d lepes, %d keret)\n", BENCH_POWER_SEGMENTS, BENCH_POWER_STEPS,
+           BENCH_POWER_FRAMES);
+    printf("Tesszellacio:  Bernstein %.2f ns/pont  gyorsitotar + Horner %.2f ns/pont  max elteres %.2e  atalakitas %ld\n",
+           bernstein_ns / BENCH_POWER_FRAMES, horner_ns / BENCH_POWER_FRAMES, max_deviation, basis.conversions);
+    printf("Terulet:       egyutthatokbol %.2f ns/szegmens  segment_moments %.2f ns/szegmens  elteres %.2e\n",
+           area_ns / BENCH_POWER_FRAMES, moments_ns / BENCH_POWER_FRAMES, fabs(power_basis_area(&basis) - moments.area));
+    power_basis_free(&basis);
+}
+
+// Position, derivatives and curvature: one batch pass against a pass per quantity
+static void bench_curvature(void) {
+    static Segment segments[BENCH_POWER_SEGMENTS];
+    static CurveSample field[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    static Point positions[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    static Point tangents[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    static double curvatures[BENCH_POWER_SEGMENTS * (BENCH_POWER_STEPS + 1)];
+    wavy_curve(segments, BENCH_POWER_SEGMENTS, (Point){ 400, 300 }, 220, 25, 11);
+    PowerBasis basis = { 0 };
+    power_basis_update(&basis, segments, BENCH_POWER_SEGMENTS);
+    double batch_ns = 0.0, separate_ns = 0.0, max_difference = 0.0;
+    int count = 0;
+    for (int frame = 0; frame < BENCH_POWER_FRAMES; ++frame) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        count = power_basis_sample_chain(&basis, BENCH_POWER_STEPS, field);
+        batch_ns += elapsed_ns(start, count);
+        start = SDL_GetPerformanceCounter();
+        int k = 0;
+        for (int i = 0; i < BENCH_POWER_SEGMENTS; ++i) {
+            for (int j = 0; j <= BENCH_POWER_STEPS; ++j, ++k) {
+                positions[k] = power_basis_eval(&basis, i, (double)j / BENCH_POWER_STEPS);
+            }
+        }
+        k = 0;
+        for (int i = 0; i < BENCH_POWER_SEGMENTS; ++i) {
+            for (int j = 0; j <= BENCH_POWER_STEPS; ++j, ++k) {
+                tangents[k] = power_basis_tangent(&basis, i, (double)j / BENCH_POWER_STEPS);
+            }
+        }
+        k = 0;
+        for (int i = 0; i < BENCH_POWER_SEGMENTS; ++i) {
+            for (int j = 0; j <= BENCH_POWER_STEPS; ++j, ++k) {
+                curvatures[k] = power_basis_curvature(&basis, i, (double)j / BENCH_POWER_STEPS);
+            }
+        }
+        separate_ns += elapsed_ns(start, count);
+    }
+    for (int k = 0; k < count; ++k) {
+        max_difference = fmax(max_difference, fabs(field[k].curvature - curvatures[k]) +
+                                              hypot(field[k].position.x - positions[k].x, field[k].position.y - positions[k].y) +
+                                              hypot(field[k].d1.x - tangents[k].x, field[k].d1.y - tangents[k].y));
+    }
+    printf("\nGorbulet mezo (%d szegmens, %d lepes)\n", BENCH_POWER_SEGMENTS, BENCH_POWER_STEPS);
+    printf("Egy menetben %.2f ns/minta  mennyisegenkent kulon %.2f ns/minta  elteres %.2e\n",
+           batch_ns / BENCH_POWER_FRAMES, separate_ns / BENCH_POWER_FRAMES, max_difference);
+    bench_sink = field[count / 2].curvature + curvatures[count / 3] + positions[count / 4].x + tangents[count / 5].y;
+    power_basis_free(&basis);
+}
+
+int run_benchmarks(void) {
+    bench_degree_specialization();
+    bench_intersections();
+    arena_reset(scratch_arena());
+    bench_queries();
+    bench_precision();
+    bench_power_basis();
+    bench_curvature();
+    arena_reset(scratch_arena());
+    bench_simplify();
+    bench_conics();
+    bench_strokes();
+    arena_print_stats(scratch_arena(), "Munka memoria");
+    scratch_arena_shutdown();
+    return 0;
+}
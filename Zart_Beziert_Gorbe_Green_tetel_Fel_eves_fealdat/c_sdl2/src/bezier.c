@@ -1,5 +1,7 @@
 #include "bezier.h"
 
+#define TESSELLATE_F_LANES 8    // samples per fixed-size block of the float path
+
 Point bezier(Point p0, Point p1, Point p2, Point p3, double t) {
     Point result;
     double u = 1 - t;
@@ -13,3 +15,123 @@ Point bezier(Point p0, Point p1, Point p2, Point p3, double t) {
 
     return result;
 }
+
+PowerCubicF power_cubic_f(const Point p[4]) {
+    PowerCubicF cubic;
+    cubic.a.x = (float)(p[3].x - 3.0 * p[2].x + 3.0 * p[1].x - p[0].x);
+    cubic.a.y = (float)(p[3].y - 3.0 * p[2].y + 3.0 * p[1].y - p[0].y);
+    cubic.b.x = (float)(3.0 * (p[2].x - 2.0 * p[1].x + p[0].x));
+    cubic.b.y = (float)(3.0 * (p[2].y - 2.0 * p[1].y + p[0].y));
+    cubic.c.x = (float)(3.0 * (p[1].x - p[0].x));
+    cubic.c.y = (float)(3.0 * (p[1].y - p[0].y));
+    cubic.d.x = (float)p[0].x;
+    cubic.d.y = (float)p[0].y;
+    return cubic;
+}
+
+// Segment i of the closed curve uses the window points[i..i+3], same as calculate_area()
+void build_segments(const Point points[], int n, Segment segments[]) {
+    for (int i = 0; i < n; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            segments[i].p[k] = points[(i + k) % n];
+        }
+    }
+}
+
+// steps + 1 samples per segment; the polyline closes implicitly from the last sample to the first
+int tessellate_segments(const Segment segments[], int count, int steps, Point out[]) {
+    int written = 0;
+    for (int i = 0; i < count; ++i) {
+        const Point* p = segments[i].p;
+        for (int j = 0; j <= steps; ++j) {
+            double t = (double)j / steps;
+            out[written++] = bezier(p[0], p[1], p[2], p[3], t);
+        }
+    }
+    return written;
+}
+
+// Float32 variant of tessellate_segments(): one conversion per segment, then float Horner
+// steps in fixed blocks of TESSELLATE_F_LANES that the compiler can vectorize
+int tessellate_segments_f(const Segment segments[], int count, int steps, PointF out[]) {
+    int written = 0;
+    float inverse_steps = 1.0f / steps;
+    for (int i = 0; i < count; ++i) {
+        PowerCubicF cubic = power_cubic_f(segments[i].p);
+        int j = 0;
+        for (; j + TESSELLATE_F_LANES - 1 <= steps; j += TESSELLATE_F_LANES) {
+            PointF* block = out + written + j;
+            for (int l = 0; l < TESSELLATE_F_LANES; ++l) {
+                float t = (j + l) * inverse_steps;
+                block[l].x = ((cubic.a.x * t + cubic.b.x) * t + cubic.c.x) * t + cubic.d.x;
+                block[l].y = ((cubic.a.y * t + cubic.b.y) * t + cubic.c.y) * t + cubic.d.y;
+            }
+        }
+        for (; j <= steps; ++j) {
+            out[written + j] = power_cubic_f_eval(&cubic, j * inverse_steps);
+        }
+        written += steps + 1;
+    }
+    return written;
+}
+
+// With the four-point window segment i ends at points[i - 1], where segment i - 1
+// starts, so walking the segments backwards gives one continuous closed outline
+// without the chord jumps of tessellate_segments(). That holds only for count == 4,
+// the segments of build_segments() over N_POINTS. Writes count * steps points.
+int tessellate_outline(const Segment segments[], int count, int steps, Point out[]) {
+    _Static_assert(N_POINTS == 4, "the backwards walk needs segments of four points over four points");
+    int written = 0;
+    for (int k = 0; k < count; ++k) {
+        const Point* p = segments[(count - k) % count].p;
+        for (int j = 0; j < steps; ++j) {
+            double t = (double)j / steps;
+            out[written++] = bezier(p[0], p[1], p[2], p[3], t);
+        }
+    }
+    return written;
+}
+
+// de Casteljau subdivision at t
+void split_segment(const Segment* segment, double t, Segment* left, Segment* right) {
+    const Point* p = segment->p;
+    Point p01 = { p[0].x + (p[1].x - p[0].x) * t, p[0].y + (p[1].y - p[0].y) * t };
+    Point p12 = { p[1].x + (p[2].x - p[1].x) * t, p[1].y + (p[2].y - p[1].y) * t };
+    Point p23 = { p[2].x + (p[3].x - p[2].x) * t, p[2].y + (p[3].y - p[2].y) * t };
+    Point p012 = { p01.x + (p12.x - p01.x) * t, p01.y + (p12.y - p01.y) * t };
+    Point p123 = { p12.x + (p23.x - p12.x) * t, p12.y + (p23.y - p12.y) * t };
+    Point mid = { p012.x + (p123.x - p012.x) * t, p012.y + (p123.y - p012.y) * t };
+    Segment l = { { p[0], p01, p012, mid } };
+    Segment r = { { mid, p123, p23, p[3] } };
+    *left = l;
+    *right = r;
+}
+
+// The part of the segment between t0 and t1, reparametrized to [0, 1]
+Segment sub_segment(const Segment* segment, double t0, double t1) {
+    Segment left, right, result;
+    if (t1 < 1.0) {
+        split_segment(segment, t1, &left, &right);
+    } else {
+        left = *segment;
+    }
+    if (t0 > 0.0) {
+        split_segment(&left, t1 > 0.0 ? t0 / t1 : 0.0, &right, &result);
+    } else {
+        result = left;
+    }
+    return result;
+}
+
+// Bounding box of the control polygon, which contains the segment (convex hull property)
+void segment_bounds(const Segment* segment, Point* min, Point* max) {
+    *min = segment->p[0];
+    *max = segment->p[0];
+    for (int k = 1; k < 4; ++k) {
+        const Point* q = &segment->p[k];
+        if (q->x < min->x) min->x = q->x;
+        if (q->y < min->y) min->y = q->y;
+        if (q->x > max->x) max->x = q->x;
+        if (q->y > max->y) max->y = q->y;
+    }
+}
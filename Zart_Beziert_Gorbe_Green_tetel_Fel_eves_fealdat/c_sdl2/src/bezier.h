@@ -1,4 +1,27 @@
 #pragma once
 #include "types.h"
 
+// Float32 cubic in power basis, x(t) = ((a.x t + b.x) t + c.x) t + d.x. The
+// coefficients are formed in double and narrowed once, so only the Horner steps
+// round in float.
+typedef struct PowerCubicF {
+    PointF a, b, c, d;
+} PowerCubicF;
+
 Point bezier(Point p0, Point p1, Point p2, Point p3, double t);
+PowerCubicF power_cubic_f(const Point p[4]);
+void build_segments(const Point points[], int n, Segment segments[]);
+int tessellate_segments(const Segment segments[], int count, int steps, Point out[]);
+int tessellate_segments_f(const Segment segments[], int count, int steps, PointF out[]);
+int tessellate_outline(const Segment segments[], int count, int steps, Point out[]);
+void split_segment(const Segment* segment, double t, Segment* left, Segment* right);
+Segment sub_segment(const Segment* segment, double t0, double t1);
+void segment_bounds(const Segment* segment, Point* min, Point* max);
+
+static inline PointF power_cubic_f_eval(const PowerCubicF* cubic, float t) {
+    PointF p = {
+        ((cubic->a.x * t + cubic->b.x) * t + cubic->c.x) * t + cubic->d.x,
+        ((cubic->a.y * t + cubic->b.y) * t + cubic->c.y) * t + cubic->d.y
+    };
+    return p;
+}
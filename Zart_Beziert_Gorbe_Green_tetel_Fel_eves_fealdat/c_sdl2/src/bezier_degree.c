@@ -0,0 +1,183 @@
+#include "bezier_degree.h"
+#include <stdbool.h>
+
+// Pascal's triangle up to the largest unrolled degree
+static const double BINOMIAL[BEZIER_MAX_UNROLLED_DEGREE + 1][BEZIER_MAX_UNROLLED_DEGREE + 1] = {
+    {1},
+    {1, 1},
+    {1, 2, 1},
+    {1, 3, 3, 1},
+    {1, 4, 6, 4, 1},
+    {1, 5, 10, 10, 5, 1},
+    {1, 6, 15, 20, 15, 6, 1},
+    {1, 7, 21, 35, 35, 21, 7, 1}
+};
+
+// Horner scheme on the Bernstein form: (1-t)^n * sum C(n,i) s^i P_i with s = t/(1-t), nested
+// from P_n down to P_0. For t > 0.5 the roles of t and 1-t swap and the nesting runs from P_0,
+// so |s| <= 1 on the whole interval.
+// The degree is a compile-time constant in every instance, so the loops unroll completely.
+#define DEFINE_BEZIER_DEGREE(N)                                                     \
+    static inline Point bezier_deg##N(const Point p[], double t) {                  \
+        bool reversed = t > 0.5;                                                    \
+        double a = reversed ? t : 1.0 - t;                                          \
+        double s = (reversed ? 1.0 - t : t) / a;                                    \
+        const Point* first = reversed ? &p[0] : &p[N];                              \
+        int step = reversed ? 1 : -1;                                               \
+        double x = first->x, y = first->y, scale = 1.0;                             \
+        _Pragma("GCC unroll 8")                                                     \
+        for (int i = 1; i <= N; ++i) {                                              \
+            x = x * s + BINOMIAL[N][i] * first[i * step].x;                         \
+            y = y * s + BINOMIAL[N][i] * first[i * step].y;                         \
+            scale *= a;                                                             \
+        }                                                                           \
+        Point result = { x * scale, y * scale };                                    \
+        return result;                                                              \
+    }                                                                               \
+    static inline Point rational_bezier_deg##N(const Point p[], const double w[], double t) { \
+        bool reversed = t > 0.5;                                                    \
+        double s = reversed ? (1.0 - t) / t : t / (1.0 - t);                        \
+        int start = reversed ? 0 : N;                                               \
+        int step = reversed ? 1 : -1;                                               \
+        double hx = w[start] * p[start].x, hy = w[start] * p[start].y, hw = w[start]; \
+        _Pragma("GCC unroll 8")                                                     \
+        for (int i = 1; i <= N; ++i) {                                              \
+            int k = start + i * step;                                               \
+            double c = BINOMIAL[N][i] * w[k];                                       \
+            hx = hx * s + c * p[k].x;                                               \
+            hy = hy * s + c * p[k].y;                                               \
+            hw = hw * s + c;                                                        \
+        }                                                                           \
+        if (hw == 0.0) {                                                            \
+            Point origin = { 0.0, 0.0 };                                            \
+            return origin;                                                          \
+        }                                                                           \
+        Point result = { hx / hw, hy / hw };                                        \
+        return result;                                                              \
+    }
+
+DEFINE_BEZIER_DEGREE(1)
+DEFINE_BEZIER_DEGREE(2)
+DEFINE_BEZIER_DEGREE(3)
+DEFINE_BEZIER_DEGREE(4)
+DEFINE_BEZIER_DEGREE(5)
+DEFINE_BEZIER_DEGREE(6)
+DEFINE_BEZIER_DEGREE(7)
+
+// Same Horner scheme with the degree known only at run time; binomials are built on the fly
+Point bezier_eval_runtime(const Point control[], int degree, double t) {
+    if (degree <= 0) {
+        return control[0];
+    }
+    bool reversed = t > 0.5;
+    double a = reversed ? t : 1.0 - t;
+    double s = (reversed ? 1.0 - t : t) / a;
+    int start = reversed ? 0 : degree;
+    int step = reversed ? 1 : -1;
+    double x = control[start].x, y = control[start].y;
+    double binomial = 1.0, scale = 1.0;
+    for (int i = 1; i <= degree; ++i) {
+        binomial = binomial * (degree - i + 1) / i;
+        x = x * s + binomial * control[start + i * step].x;
+        y = y * s + binomial * control[start + i * step].y;
+        scale *= a;
+    }
+    Point result = { x * scale, y * scale };
+    return result;
+}
+
+Point rational_bezier_eval_runtime(const Point control[], const double weights[], int degree, double t) {
+    if (degree <= 0) {
+        return control[0];
+    }
+    bool reversed = t > 0.5;
+    double s = reversed ? (1.0 - t) / t : t / (1.0 - t);
+    int start = reversed ? 0 : degree;
+    int step = reversed ? 1 : -1;
+    double hx = weights[start] * control[start].x;
+    double hy = weights[start] * control[start].y;
+    double hw = weights[start];
+    double binomial = 1.0;
+    for (int i = 1; i <= degree; ++i) {
+        int k = start + i * step;
+        binomial = binomial * (degree - i + 1) / i;
+        double c = binomial * weights[k];
+        hx = hx * s + c * control[k].x;
+        hy = hy * s + c * control[k].y;
+        hw = hw * s + c;
+    }
+    if (hw == 0.0) {
+        Point origin = { 0.0, 0.0 };
+        return origin;
+    }
+    Point result = { hx / hw, hy / hw };
+    return result;
+}
+
+Point bezier_eval(const Point control[], int degree, double t) {
+    switch (degree) {
+        case 1: return bezier_deg1(control, t);
+        case 2: return bezier_deg2(control, t);
+        case 3: return bezier_deg3(control, t);
+        case 4: return bezier_deg4(control, t);
+        case 5: return bezier_deg5(control, t);
+        case 6: return bezier_deg6(control, t);
+        case 7: return bezier_deg7(control, t);
+        default: return bezier_eval_runtime(control, degree, t);
+    }
+}
+
+Point rational_bezier_eval(const Point control[], const double weights[], int degree, double t) {
+    switch (degree) {
+        case 1: return rational_bezier_deg1(control, weights, t);
+        case 2: return rational_bezier_deg2(control, weights, t);
+        case 3: return rational_bezier_deg3(control, weights, t);
+        case 4: return rational_bezier_deg4(control, weights, t);
+        case 5: return rational_bezier_deg5(control, weights, t);
+        case 6: return rational_bezier_deg6(control, weights, t);
+        case 7: return rational_bezier_deg7(control, weights, t);
+        default: return rational_bezier_eval_runtime(control, weights, degree, t);
+    }
+}
+
+// The batch versions dispatch once, so the inner loop calls a single inlined instance
+#define BATCH_CASE(N)                                                   \
+    case N:                                                             \
+        for (int k = 0; k < count; ++k) out[k] = bezier_deg##N(control, t[k]); \
+        break;
+
+void bezier_eval_batch(const Point control[], int degree, const double t[], int count, Point out[]) {
+    switch (degree) {
+        BATCH_CASE(1)
+        BATCH_CASE(2)
+        BATCH_CASE(3)
+        BATCH_CASE(4)
+        BATCH_CASE(5)
+        BATCH_CASE(6)
+        BATCH_CASE(7)
+        default:
+            for (int k = 0; k < count; ++k) out[k] = bezier_eval_runtime(control, degree, t[k]);
+            break;
+    }
+}
+
+#define RATIONAL_BATCH_CASE(N)                                          \
+    case N:                                                             \
+        for (int k = 0; k < count; ++k) out[k] = rational_bezier_deg##N(control, weights, t[k]); \
+        break;
+
+void rational_bezier_eval_batch(const Point control[], const double weights[], int degree,
+                                const double t[], int count, Point out[]) {
+    switch (degree) {
+        RATIONAL_BATCH_CASE(1)
+        RATIONAL_BATCH_CASE(2)
+        RATIONAL_BATCH_CASE(3)
+        RATIONAL_BATCH_CASE(4)
+        RATIONAL_BATCH_CASE(5)
+        RATIONAL_BATCH_CASE(6)
+        RATIONAL_BATCH_CASE(7)
+        default:
+            for (int k = 0; k < count; ++k) out[k] = rational_bezier_eval_runtime(control, weights, degree, t[k]);
+            break;
+    }
+}
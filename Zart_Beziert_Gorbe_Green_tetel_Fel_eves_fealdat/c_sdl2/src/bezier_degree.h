@@ -0,0 +1,13 @@
+#pragma once
+#include "types.h"
+
+// Degrees up to this one get their own unrolled evaluator; higher ones use the runtime loop
+#define BEZIER_MAX_UNROLLED_DEGREE 7
+
+Point bezier_eval(const Point control[], int degree, double t);
+Point rational_bezier_eval(const Point control[], const double weights[], int degree, double t);
+void bezier_eval_batch(const Point control[], int degree, const double t[], int count, Point out[]);
+void rational_bezier_eval_batch(const Point control[], const double weights[], int degree,
+                                const double t[], int count, Point out[]);
+Point bezier_eval_runtime(const Point control[], int degree, double t);
+Point rational_bezier_eval_runtime(const Point control[], const double weights[], int degree, double t);
@@ -0,0 +1,251 @@
+#include "conic.h"
+#include <math.h>
+
+#define SEGMENT_SERIES_LIMIT 1e-4     // |1 - w^2| below which the series replaces the closed forms
+#define CARLSON_RF_TOLERANCE 0.0025   // truncation error ~ tolerance^6
+#define CARLSON_RD_TOLERANCE 0.0015
+#define AGM_TOLERANCE 1e-15
+#define LENGTH_TOLERANCE 1e-10
+#define LENGTH_MAX_DEPTH 16
+
+static Point add(Point a, Point b) {
+    Point p = { a.x + b.x, a.y + b.y };
+    return p;
+}
+
+static Point sub(Point a, Point b) {
+    Point p = { a.x - b.x, a.y - b.y };
+    return p;
+}
+
+static Point scale(Point a, double s) {
+    Point p = { a.x * s, a.y * s };
+    return p;
+}
+
+static double cross(Point a, Point b) {
+    return a.x * b.y - b.x * a.y;
+}
+
+Conic conic_from_points(Point p0, Point p1, Point p2, double w) {
+    Conic conic = { { p0, p1, p2 }, w };
+    return conic;
+}
+
+// Image of the unit circle arc under the ellipse's affine map
+static Point ellipse_point(Point center, double rx, double ry, double cos_r, double sin_r, double x, double y) {
+    Point p = { center.x + rx * x * cos_r - ry * y * sin_r, center.y + rx * x * sin_r + ry * y * cos_r };
+    return p;
+}
+
+// Exact arc of the ellipse from parameter angle start over sweep, split into pieces of at most
+// a quarter turn. A circular arc of opening d has weight cos(d/2) and its control point on the
+// bisector at 1/cos(d/2); both survive the affine map, so the ellipse is exact too.
+int conic_ellipse_arc(Point center, double rx, double ry, double rotation, double start, double sweep,
+                      Conic out[CONIC_MAX_ARC_PIECES]) {
+    if (sweep == 0.0) {
+        return 0;
+    }
+    if (fabs(sweep) > 2.0 * M_PI) {
+        sweep = sweep > 0.0 ? 2.0 * M_PI : -2.0 * M_PI;
+    }
+    int pieces = (int)ceil(fabs(sweep) / (0.5 * M_PI) - 1e-12);
+    if (pieces < 1) pieces = 1;
+    if (pieces > CONIC_MAX_ARC_PIECES) pieces = CONIC_MAX_ARC_PIECES;
+    double step = sweep / pieces;
+    double w = cos(0.5 * step);
+    double cos_r = cos(rotation), sin_r = sin(rotation);
+    for (int i = 0; i < pieces; ++i) {
+        double a0 = start + i * step, a1 = a0 + step, mid = a0 + 0.5 * step;
+        out[i].p[0] = ellipse_point(center, rx, ry, cos_r, sin_r, cos(a0), sin(a0));
+        out[i].p[1] = ellipse_point(center, rx, ry, cos_r, sin_r, cos(mid) / w, sin(mid) / w);
+        out[i].p[2] = ellipse_point(center, rx, ry, cos_r, sin_r, cos(a1), sin(a1));
+        out[i].w = w;
+    }
+    return pieces;
+}
+
+int conic_ellipse(Point center, double rx, double ry, double rotation, Conic out[CONIC_MAX_ARC_PIECES]) {
+    return conic_ellipse_arc(center, rx, ry, rotation, 0.0, 2.0 * M_PI, out);
+}
+
+Point conic_eval(const Conic* conic, double t) {
+    double s = 1.0 - t;
+    double b0 = s * s, b1 = 2.0 * conic->w * s * t, b2 = t * t;
+    double denom = b0 + b1 + b2;
+    Point p = {
+        (b0 * conic->p[0].x + b1 * conic->p[1].x + b2 * conic->p[2].x) / denom,
+        (b0 * conic->p[0].y + b1 * conic->p[1].y + b2 * conic->p[2].y) / denom,
+    };
+    return p;
+}
+
+// Area between the arc and its chord as a fraction of the control triangle. With w = cos(a)
+// this is (a - sin(a)cos(a))cos(a)/sin^3(a); the hyperbolic form continues it past w = 1.
+// Near w = 1 both forms cancel badly, so the series in u = 1 - w^2 takes over there.
+// For -1 < w < 0 the arc is the complementary one, on the far side of the chord from p1;
+// the circular form holds there unchanged and turns negative. At w <= -1 the arc runs
+// through infinity and has no area.
+static double segment_fraction(double w) {
+    if (w <= -1.0) {
+        return NAN;
+    }
+    double u = (1.0 - w) * (1.0 + w);
+    if (w > 0.0 && fabs(u) < SEGMENT_SERIES_LIMIT) {
+        return 2.0 / 3.0 - u * (2.0 / 15.0 + u * 8.0 / 105.0);
+    }
+    if (u > 0.0) {
+        double s = sqrt(u);
+        return (acos(w) - w * s) * w / (u * s);
+    }
+    double s = sqrt(-u);
+    return w * (w * s - acosh(w)) / (-u * s);
+}
+
+// Green's theorem over the arc: 1/2 of the integral of x dy - y dx. Summed over a closed chain
+// this is the enclosed area, with no tessellation.
+double conic_green(const Conic* conic) {
+    const Point* p = conic->p;
+    return 0.5 * cross(p[0], p[2]) + 0.5 * cross(sub(p[1], p[0]), sub(p[2], p[0])) * segment_fraction(conic->w);
+}
+
+double conic_chain_area(const Conic conics[], int count) {
+    double area = 0.0;
+    for (int i = 0; i < count; ++i) {
+        area += conic_green(&conics[i]);
+    }
+    return fabs(area);
+}
+
+static double conic_speed(const Conic* conic, double t) {
+    const Point* p = conic->p;
+    double s = 1.0 - t, w = conic->w;
+    double denom = s * s + 2.0 * w * s * t + t * t;
+    double d_denom = -2.0 * s + 2.0 * w * (1.0 - 2.0 * t) + 2.0 * t;
+    Point n = add(add(scale(p[0], s * s), scale(p[1], 2.0 * w * s * t)), scale(p[2], t * t));
+    Point dn = add(add(scale(p[0], -2.0 * s), scale(p[1], 2.0 * w * (1.0 - 2.0 * t))), scale(p[2], 2.0 * t));
+    Point d = scale(sub(scale(dn, denom), scale(n, d_denom)), 1.0 / (denom * denom));
+    return sqrt(d.x * d.x + d.y * d.y);
+}
+
+// 5-point Gauss-Legendre over [t0, t1]
+static double gauss_length(const Conic* conic, double t0, double t1) {
+    static const double nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+    static const double weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+    double half = 0.5 * (t1 - t0), mid = 0.5 * (t0 + t1);
+    double sum = 0.0;
+    for (int k = 0; k < 5; ++k) {
+        sum += weights[k] * conic_speed(conic, mid + half * nodes[k]);
+    }
+    return sum * half;
+}
+
+static double adaptive_length(const Conic* conic, double t0, double t1, double whole, int depth) {
+    double mid = 0.5 * (t0 + t1);
+    double left = gauss_length(conic, t0, mid);
+    double right = gauss_length(conic, mid, t1);
+    if (depth >= LENGTH_MAX_DEPTH || fabs(left + right - whole) <= LENGTH_TOLERANCE * (left + right)) {
+        return left + right;
+    }
+    return adaptive_length(conic, t0, mid, left, depth + 1) + adaptive_length(conic, mid, t1, right, depth + 1);
+}
+
+// Any conic arc; ellipse arcs with known axes are cheaper through ellipse_arc_length()
+double conic_length(const Conic* conic) {
+    return adaptive_length(conic, 0.0, 1.0, gauss_length(conic, 0.0, 1.0), 0);
+}
+
+// Carlson's symmetric integrals by the duplication theorem
+static double carlson_rf(double x, double y, double z) {
+    double mean, dx, dy, dz;
+    for (;;) {
+        double sx = sqrt(x), sy = sqrt(y), sz = sqrt(z);
+        double lambda = sx * (sy + sz) + sy * sz;
+        x = 0.25 * (x + lambda);
+        y = 0.25 * (y + lambda);
+        z = 0.25 * (z + lambda);
+        mean = (x + y + z) / 3.0;
+        dx = (mean - x) / mean;
+        dy = (mean - y) / mean;
+        dz = (mean - z) / mean;
+        if (fmax(fmax(fabs(dx), fabs(dy)), fabs(dz)) <= CARLSON_RF_TOLERANCE) {
+            break;
+        }
+    }
+    double e2 = dx * dy - dz * dz, e3 = dx * dy * dz;
+    return (1.0 + (e2 / 24.0 - 0.1 - 3.0 / 44.0 * e3) * e2 + e3 / 14.0) / sqrt(mean);
+}
+
+static double carlson_rd(double x, double y, double z) {
+    double sum = 0.0, factor = 1.0, mean, dx, dy, dz;
+    for (;;) {
+        double sx = sqrt(x), sy = sqrt(y), sz = sqrt(z);
+        double lambda = sx * (sy + sz) + sy * sz;
+        sum += factor / (sz * (z + lambda));
+        factor *= 0.25;
+        x = 0.25 * (x + lambda);
+        y = 0.25 * (y + lambda);
+        z = 0.25 * (z + lambda);
+        mean = 0.2 * (x + y + 3.0 * z);
+        dx = (mean - x) / mean;
+        dy = (mean - y) / mean;
+        dz = (mean - z) / mean;
+        if (fmax(fmax(fabs(dx), fabs(dy)), fabs(dz)) <= CARLSON_RD_TOLERANCE) {
+            break;
+        }
+    }
+    double ea = dx * dy, eb = dz * dz, ec = ea - eb, ed = ea - 6.0 * eb, ee = ed + 2.0 * ec;
+    double series = 1.0 + ed * (-3.0 / 14.0 + 9.0 / 88.0 * ed - 9.0 / 52.0 * dz * ee) +
+                    dz * (ee / 6.0 + dz * (-9.0 / 22.0 * ec + dz * 3.0 / 26.0 * ea));
+    return 3.0 * sum + factor * series / (mean * sqrt(mean));
+}
+
+// Incomplete elliptic integral of the second kind E(phi | k^2) for any phi
+static double elliptic_e(double phi, double k2) {
+    double turns = round(phi / M_PI);
+    double reduced = phi - turns * M_PI;
+    double s = sin(reduced), c = cos(reduced);
+    double q = 1.0 - k2 * s * s;
+    double e = s * carlson_rf(c * c, q, 1.0) - k2 / 3.0 * s * s * s * carlson_rd(c * c, q, 1.0);
+    if (turns != 0.0) {
+        double complete = carlson_rf(0.0, 1.0 - k2, 1.0) - k2 / 3.0 * carlson_rd(0.0, 1.0 - k2, 1.0);
+        e += 2.0 * turns * complete;
+    }
+    return e;
+}
+
+// Arithmetic-geometric mean form of 4a E(e); converges quadratically
+double ellipse_perimeter(double rx, double ry) {
+    double major = fmax(fabs(rx), fabs(ry)), minor = fmin(fabs(rx), fabs(ry));
+    double a = major, b = minor;
+    double sum = 0.5 * (a * a - b * b), power = 0.5;
+    while (a - b > AGM_TOLERANCE * a) {
+        double c = 0.5 * (a - b);
+        double next = 0.5 * (a + b);
+        b = sqrt(a * b);
+        a = next;
+        power *= 2.0;
+        sum += power * c * c;
+    }
+    return 4.0 * M_PI * (major * major - sum) / (a + b);
+}
+
+// Integral of sqrt(rx^2 sin^2 t + ry^2 cos^2 t) from 0 to phi
+static double ellipse_length_to(double rx, double ry, double phi) {
+    if (ry >= rx) {
+        return ry * elliptic_e(phi, 1.0 - rx * rx / (ry * ry));
+    }
+    double k2 = 1.0 - ry * ry / (rx * rx);
+    return rx * (elliptic_e(0.5 * M_PI, k2) - elliptic_e(0.5 * M_PI - phi, k2));
+}
+
+// Length of (rx cos t, ry sin t) for t from start over sweep, the parameterization used by
+// conic_ellipse_arc()
+double ellipse_arc_length(double rx, double ry, double start, double sweep) {
+    rx = fabs(rx);
+    ry = fabs(ry);
+    if (rx == 0.0 && ry == 0.0) {
+        return 0.0;
+    }
+    return fabs(ellipse_length_to(rx, ry, start + sweep) - ellipse_length_to(rx, ry, start));
+}
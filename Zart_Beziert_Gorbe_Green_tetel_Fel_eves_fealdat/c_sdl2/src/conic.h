@@ -0,0 +1,23 @@
+#pragma once
+#include "types.h"
+
+// Rational quadratic Bezier with end weights 1:
+//   C(t) = ((1-t)^2 p0 + 2w t(1-t) p1 + t^2 p2) / ((1-t)^2 + 2w t(1-t) + t^2)
+// w < 1 gives an elliptic arc, w = 1 a parabola and w > 1 a hyperbola.
+#define CONIC_MAX_ARC_PIECES 4
+
+typedef struct Conic {
+    Point p[3];
+    double w;
+} Conic;
+
+Conic conic_from_points(Point p0, Point p1, Point p2, double w);
+int conic_ellipse_arc(Point center, double rx, double ry, double rotation, double start, double sweep,
+                      Conic out[CONIC_MAX_ARC_PIECES]);
+int conic_ellipse(Point center, double rx, double ry, double rotation, Conic out[CONIC_MAX_ARC_PIECES]);
+Point conic_eval(const Conic* conic, double t);
+double conic_green(const Conic* conic);
+double conic_chain_area(const Conic conics[], int count);
+double conic_length(const Conic* conic);
+double ellipse_perimeter(double rx, double ry);
+double ellipse_arc_length(double rx, double ry, double start, double sweep);
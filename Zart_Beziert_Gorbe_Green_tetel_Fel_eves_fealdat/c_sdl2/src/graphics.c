@@ -1,9 +1,155 @@
 #include "graphics.h"
 #include "bezier.h"
+#include "raster.h"
+#include "arena.h"
+#include "offset.h"
+#include "power_basis.h"
+#include "profile.h"
+#include <math.h>
+#include <stdlib.h>
 
-void render_scene(SDL_Renderer* renderer, Point points[], int steps) {
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-    SDL_RenderClear(renderer);
+#define BACKGROUND_COLOR 0xFFFFFFFFu
+#define FILL_COLOR 0xFFD8E4FFu
+#define STROKE_COLOR 0xFF5070B0u
+#define STROKE_STEPS 16             // per offset cubic
+#define STROKE_TOLERANCE 0.1
+#define COMB_STEPS 24               // teeth per segment
+#define COMB_MAX_LENGTH 60.0        // pixel length of the longest tooth
+
+static SDL_Texture* fill_texture = NULL;
+static Raster fill_raster;
+static Precision scene_precision = PRECISION_DOUBLE;
+static Stroke stroke;
+static PowerBasis scene_basis;      // coefficients of the drawn curve, kept across frames
+static double stroke_half_width = 0.0;
+static bool comb_visible = false;
+
+// With a NULL renderer only the software raster is set up, for headless replays
+bool graphics_init(SDL_Renderer* renderer) {
+    if (!raster_init(&fill_raster, WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        return false;
+    }
+    if (renderer == NULL) {
+        return true;
+    }
+    fill_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                     WINDOW_WIDTH, WINDOW_HEIGHT);
+    return fill_texture != NULL;
+}
+
+void graphics_shutdown(void) {
+    if (fill_texture != NULL) {
+        SDL_DestroyTexture(fill_texture);
+        fill_texture = NULL;
+    }
+    raster_free(&fill_raster);
+    stroke_free(&stroke);
+    power_basis_free(&scene_basis);
+}
+
+// Precision of the tessellation behind rasterize_scene() and render_scene()
+void graphics_set_precision(Precision precision) {
+    scene_precision = precision;
+}
+
+// Thick outline drawn around the curve; 0 keeps the 1-pixel line only
+void graphics_set_stroke(double half_width) {
+    stroke_half_width = half_width;
+}
+
+// Curvature comb over the curve
+void graphics_set_comb(bool visible) {
+    comb_visible = visible;
+}
+
+// Area of the stroke band drawn in the last frame, -1 without a stroke
+double graphics_stroke_area(void) {
+    return stroke_half_width > 0.0 && stroke.valid ? stroke.band_area : -1.0;
+}
+
+// Both sides go into one polygon: the left side, then the right side backwards. The two
+// bridge edges between them cancel, and nonzero winding leaves exactly the band.
+static void fill_stroke(const Point points[]) {
+    if (stroke_half_width <= 0.0 || !stroke_update(&stroke, points, stroke_half_width, JOIN_ROUND, STROKE_TOLERANCE)) {
+        return;
+    }
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    int left = stroke.counts[0] * (STROKE_STEPS + 1), right = stroke.counts[1] * (STROKE_STEPS + 1);
+    Point* polygon = arena_alloc(scratch, (left + 2 * right) * sizeof(Point));
+    if (polygon != NULL) {
+        Point* reversed = polygon + left + right;
+        tessellate_segments(stroke.sides[0], stroke.counts[0], STROKE_STEPS, polygon);
+        tessellate_segments(stroke.sides[1], stroke.counts[1], STROKE_STEPS, reversed);
+        for (int i = 0; i < right; ++i) {
+            polygon[left + i] = reversed[right - 1 - i];
+        }
+        fill_polygon_nonzero(&fill_raster, polygon, left + right, STROKE_COLOR, NULL);
+    }
+    arena_release(scratch, mark);
+}
+
+static long fill_polyline(const Point samples[], const PointF samples_f[], int count) {
+    raster_clear(&fill_raster, BACKGROUND_COLOR);
+    long winding_area = 0;
+    if (samples != NULL) {
+        fill_polygon_nonzero(&fill_raster, samples, count, FILL_COLOR, &winding_area);
+    } else {
+        fill_polygon_nonzero_f(&fill_raster, samples_f, count, FILL_COLOR, &winding_area);
+    }
+    return labs(winding_area);
+}
+
+// The polyline lives in the scratch arena until the caller releases it
+static bool tessellate_scene(Arena* scratch, Point points[], int steps, Point** samples, PointF** samples_f) {
+    int count = N_POINTS * (steps + 1);
+    PROFILE_COUNT(PROFILE_POINTS, count);
+    Segment segments[N_POINTS];
+    build_segments(points, N_POINTS, segments);
+    *samples = NULL;
+    *samples_f = NULL;
+    if (scene_precision == PRECISION_FLOAT) {
+        *samples_f = arena_alloc(scratch, count * sizeof(PointF));
+        if (*samples_f == NULL) {
+            return false;
+        }
+        tessellate_segments_f(segments, N_POINTS, steps, *samples_f);
+    } else {
+        *samples = arena_alloc(scratch, count * sizeof(Point));
+        if (*samples == NULL) {
+            return false;
+        }
+        // While the curve is not dragged the coefficients stay valid and a frame is pure Horner
+        if (power_basis_update(&scene_basis, segments, N_POINTS)) {
+            power_basis_tessellate(&scene_basis, steps, *samples);
+        } else {
+            tessellate_segments(segments, N_POINTS, steps, *samples);
+        }
+    }
+    return true;
+}
+
+// Tessellates and fills the curve into the software raster. Returns the pixel estimate
+// of the area in the same winding-weighted sense as calculate_area(), so the two can be
+// compared directly.
+long rasterize_scene(Point points[], int steps) {
+    PROFILE_SCOPE("rasterize_scene");
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Point* samples;
+    PointF* samples_f;
+    long pixel_area = -1;
+    if (tessellate_scene(scratch, points, steps, &samples, &samples_f)) {
+        pixel_area = fill_polyline(samples, samples_f, N_POINTS * (steps + 1));
+    }
+    arena_release(scratch, mark);
+    return pixel_area;
+}
+
+static void draw_curve(SDL_Renderer* renderer, const Point points[], const Point samples[], const PointF samples_f[],
+                       int steps) {
+    SDL_UpdateTexture(fill_texture, NULL, fill_raster.pixels, fill_raster.width * sizeof(uint32_t));
+    SDL_RenderCopy(renderer, fill_texture, NULL, NULL);
 
     SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
     for (int i = 0; i < N_POINTS; ++i) {
@@ -13,18 +159,81 @@ void render_scene(SDL_Renderer* renderer, Point points[], int steps) {
 
     SDL_SetRenderDrawColor(renderer, 160, 160, 160, SDL_ALPHA_OPAQUE);
     for (int i = 0; i < N_POINTS; ++i) {
-        Point p0 = points[i];
-        Point p1 = points[(i + 1) % N_POINTS];
-        Point p2 = points[(i + 2) % N_POINTS];
-        Point p3 = points[(i + 3) % N_POINTS];
-        Point prev_point = p0;
-        for (int j = 0; j <= steps; ++j) {
-            double t = (double)j / steps;
-            Point new_point = bezier(p0, p1, p2, p3, t);
-            SDL_RenderDrawLine(renderer, prev_point.x, prev_point.y, new_point.x, new_point.y);
-            prev_point = new_point;
+        int first = i * (steps + 1);
+        for (int j = first + 1; j <= first + steps; ++j) {
+            if (samples != NULL) {
+                SDL_RenderDrawLine(renderer, samples[j - 1].x, samples[j - 1].y, samples[j].x, samples[j].y);
+            } else {
+                SDL_RenderDrawLine(renderer, samples_f[j - 1].x, samples_f[j - 1].y, samples_f[j].x, samples_f[j].y);
+            }
         }
     }
+    PROFILE_COUNT(PROFILE_DRAW_CALLS, 1 + 2 * N_POINTS + N_POINTS * steps);
+}
 
-    SDL_RenderPresent(renderer);
+// Teeth along the normal with length proportional to the curvature, on the convex side,
+// and the line through their tips. Scaled so that the longest tooth has a fixed length.
+static void draw_comb(SDL_Renderer* renderer, const Point points[]) {
+    Segment segments[N_POINTS];
+    build_segments(points, N_POINTS, segments);
+    if (!comb_visible || !power_basis_update(&scene_basis, segments, N_POINTS)) {
+        return;
+    }
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    int count = N_POINTS * (COMB_STEPS + 1);
+    CurveSample* samples = arena_alloc(scratch, count * sizeof(CurveSample));
+    if (samples != NULL) {
+        power_basis_sample_chain(&scene_basis, COMB_STEPS, samples);
+        double max_curvature = 0.0;
+        for (int i = 0; i < count; ++i) {
+            max_curvature = fmax(max_curvature, fabs(samples[i].curvature));
+        }
+        double scale = max_curvature > 0.0 ? COMB_MAX_LENGTH / max_curvature : 0.0;
+        Point prev_tip = { 0.0, 0.0 };
+        for (int i = 0; i < count; ++i) {
+            const CurveSample* s = &samples[i];
+            double speed = hypot(s->d1.x, s->d1.y);
+            double length = speed > 0.0 ? -s->curvature * scale / speed : 0.0;
+            Point tip = { s->position.x - s->d1.y * length, s->position.y + s->d1.x * length };
+            SDL_SetRenderDrawColor(renderer, 220, 120, 40, SDL_ALPHA_OPAQUE);
+            SDL_RenderDrawLine(renderer, s->position.x, s->position.y, tip.x, tip.y);
+            if (i % (COMB_STEPS + 1) != 0) {
+                SDL_SetRenderDrawColor(renderer, 180, 60, 20, SDL_ALPHA_OPAQUE);
+                SDL_RenderDrawLine(renderer, prev_tip.x, prev_tip.y, tip.x, tip.y);
+            }
+            prev_tip = tip;
+        }
+        PROFILE_COUNT(PROFILE_DRAW_CALLS, 2 * count);
+    }
+    arena_release(scratch, mark);
+}
+
+// Draws an already tessellated curve (tessellate_segments() layout), e.g. one finished
+// by the worker pipeline. The caller presents the frame, so overlays can still be drawn
+// on top.
+long render_geometry(SDL_Renderer* renderer, const Point points[], const Point samples[], int steps) {
+    PROFILE_SCOPE("render_geometry");
+    long pixel_area = fill_polyline(samples, NULL, N_POINTS * (steps + 1));
+    fill_stroke(points);
+    draw_curve(renderer, points, samples, NULL, steps);
+    draw_comb(renderer, points);
+    return pixel_area;
+}
+
+long render_scene(SDL_Renderer* renderer, Point points[], int steps) {
+    PROFILE_SCOPE("render_scene");
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Point* samples;
+    PointF* samples_f;
+    long pixel_area = -1;
+    if (tessellate_scene(scratch, points, steps, &samples, &samples_f)) {
+        pixel_area = fill_polyline(samples, samples_f, N_POINTS * (steps + 1));
+        fill_stroke(points);
+        draw_curve(renderer, points, samples, samples_f, steps);
+        draw_comb(renderer, points);
+    }
+    arena_release(scratch, mark);
+    return pixel_area;
 }
@@ -1,5 +1,14 @@
 #pragma once
 #include "types.h"
 #include <SDL2/SDL.h>
+#include <stdbool.h>
 
-void render_scene(SDL_Renderer* renderer, Point points[], int steps);
+bool graphics_init(SDL_Renderer* renderer);
+void graphics_shutdown(void);
+void graphics_set_precision(Precision precision);
+void graphics_set_stroke(double half_width);
+void graphics_set_comb(bool visible);
+double graphics_stroke_area(void);
+long rasterize_scene(Point points[], int steps);
+long render_geometry(SDL_Renderer* renderer, const Point points[], const Point samples[], int steps);
+long render_scene(SDL_Renderer* renderer, Point points[], int steps);
@@ -0,0 +1,340 @@
+#include "intersect.h"
+#include "arena.h"
+#include "bezier.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define CLIP_EPSILON 1e-9       // parameter width at which a clipped pair counts as converged
+#define CLIP_MAX_DEPTH 64
+#define CLIP_BUDGET 4096        // recursion steps per segment pair; stops tangent or overlapping runs
+#define DUPLICATE_DISTANCE 1e-6
+#define ENDPOINT_PARAMETER 1e-6     // hits this close to t = 0 or 1 sit on a segment endpoint
+#define BOX_TOLERANCE 1e-7      // rounding slack for boxes that have collapsed to a line or a point
+
+typedef struct ClipContext {
+    Intersection* out;
+    int max_out;
+    int count;
+    int pair_start;     // first hit of the current segment pair
+    int segment_a;
+    int segment_b;
+    int budget;
+} ClipContext;
+
+typedef struct BoxEntry {
+    Point min;
+    Point max;
+    int index;
+    int set;
+} BoxEntry;
+
+static bool boxes_overlap(const Segment* a, const Segment* b) {
+    Point a_min, a_max, b_min, b_max;
+    segment_bounds(a, &a_min, &a_max);
+    segment_bounds(b, &b_min, &b_max);
+    return a_min.x <= b_max.x + BOX_TOLERANCE && b_min.x <= a_max.x + BOX_TOLERANCE &&
+           a_min.y <= b_max.y + BOX_TOLERANCE && b_min.y <= a_max.y + BOX_TOLERANCE;
+}
+
+static bool at_endpoint(double t) {
+    return t < ENDPOINT_PARAMETER || t > 1.0 - ENDPOINT_PARAMETER;
+}
+
+// The clipping recursion can reach one crossing on several branches, so hits are compared
+// with the others of the same pair. Only a hit on a segment endpoint can repeat one found
+// by a neighbouring pair; those few are compared with every earlier hit.
+static void record(ClipContext* ctx, double t_a, double t_b, Point point) {
+    int first = at_endpoint(t_a) || at_endpoint(t_b) ? 0 : ctx->pair_start;
+    for (int i = first; i < ctx->count; ++i) {
+        double dx = ctx->out[i].point.x - point.x;
+        double dy = ctx->out[i].point.y - point.y;
+        if (dx * dx + dy * dy < DUPLICATE_DISTANCE * DUPLICATE_DISTANCE) {
+            return;
+        }
+    }
+    if (ctx->count < ctx->max_out) {
+        Intersection* hit = &ctx->out[ctx->count++];
+        hit->segment_a = ctx->segment_a;
+        hit->segment_b = ctx->segment_b;
+        hit->t_a = t_a;
+        hit->t_b = t_b;
+        hit->point = point;
+    }
+}
+
+// Clips `curve` against the fat line of `line_curve` and returns the surviving parameter range
+static bool fat_line_clip(const Segment* line_curve, const Segment* curve, double* t_min, double* t_max) {
+    const Point* p = line_curve->p;
+    double nx = p[0].y - p[3].y;
+    double ny = p[3].x - p[0].x;
+    double length = sqrt(nx * nx + ny * ny);
+    if (length < 1e-12) {
+        // Closed control polygon: use the chord to the farthest inner control point instead
+        int far = fabs(p[1].x - p[0].x) + fabs(p[1].y - p[0].y) > fabs(p[2].x - p[0].x) + fabs(p[2].y - p[0].y) ? 1 : 2;
+        nx = p[0].y - p[far].y;
+        ny = p[far].x - p[0].x;
+        length = sqrt(nx * nx + ny * ny);
+        if (length < 1e-12) {
+            // Clipped down to a point: cut across the other curve's chord instead, which
+            // keeps the part of it nearest the point
+            nx = curve->p[3].x - curve->p[0].x;
+            ny = curve->p[3].y - curve->p[0].y;
+            length = sqrt(nx * nx + ny * ny);
+        }
+        if (length < 1e-12) {
+            nx = 0.0;
+            ny = 1.0;
+            length = 1.0;
+        }
+    }
+    nx /= length;
+    ny /= length;
+    double c = -(nx * p[0].x + ny * p[0].y);
+    double d1 = nx * p[1].x + ny * p[1].y + c;
+    double d2 = nx * p[2].x + ny * p[2].y + c;
+    double factor = d1 * d2 > 0 ? 3.0 / 4.0 : 4.0 / 9.0;
+    double d_min = factor * fmin(0.0, fmin(d1, d2));
+    double d_max = factor * fmax(0.0, fmax(d1, d2));
+
+    // Distance curve: control points (i/3, e_i); clip its convex hull against [d_min, d_max]
+    double e[4];
+    for (int i = 0; i < 4; ++i) {
+        e[i] = nx * curve->p[i].x + ny * curve->p[i].y + c;
+    }
+    *t_min = 1.0;
+    *t_max = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        if (e[i] >= d_min && e[i] <= d_max) {
+            *t_min = fmin(*t_min, i / 3.0);
+            *t_max = fmax(*t_max, i / 3.0);
+        }
+        for (int j = i + 1; j < 4; ++j) {
+            double bounds[2] = { d_min, d_max };
+            for (int k = 0; k < 2; ++k) {
+                if ((e[i] - bounds[k]) * (e[j] - bounds[k]) < 0.0) {
+                    double t = (i + (bounds[k] - e[i]) * (j - i) / (e[j] - e[i])) / 3.0;
+                    *t_min = fmin(*t_min, t);
+                    *t_max = fmax(*t_max, t);
+                }
+            }
+        }
+    }
+    return *t_min <= *t_max;
+}
+
+// a covers [a0, a1] of its original segment and b covers [b0, b1]; `swapped` tells whether a is
+// currently the second curve. Every step clips a against b's fat line and then swaps the roles.
+static void clip_pair(ClipContext* ctx, Segment a, double a0, double a1, Segment b, double b0, double b1,
+                      bool swapped, int depth) {
+    if (ctx->budget-- <= 0 || !boxes_overlap(&a, &b)) {
+        return;
+    }
+    if ((a1 - a0 < CLIP_EPSILON && b1 - b0 < CLIP_EPSILON) || depth >= CLIP_MAX_DEPTH) {
+        Point point = { (a.p[0].x + a.p[3].x) * 0.5, (a.p[0].y + a.p[3].y) * 0.5 };
+        double t_a = (a0 + a1) * 0.5, t_b = (b0 + b1) * 0.5;
+        record(ctx, swapped ? t_b : t_a, swapped ? t_a : t_b, point);
+        return;
+    }
+
+    double t_min, t_max;
+    if (!fat_line_clip(&b, &a, &t_min, &t_max)) {
+        return;
+    }
+    Segment clipped = sub_segment(&a, t_min, t_max);
+    double c0 = a0 + (a1 - a0) * t_min;
+    double c1 = a0 + (a1 - a0) * t_max;
+
+    if (t_max - t_min <= 0.8) {
+        clip_pair(ctx, b, b0, b1, clipped, c0, c1, !swapped, depth + 1);
+        return;
+    }
+    // Clipping stalls on multiple intersections: halve the longer curve and continue on both halves
+    Segment left, right;
+    if (c1 - c0 > b1 - b0) {
+        double mid = (c0 + c1) * 0.5;
+        split_segment(&clipped, 0.5, &left, &right);
+        clip_pair(ctx, b, b0, b1, left, c0, mid, !swapped, depth + 1);
+        clip_pair(ctx, b, b0, b1, right, mid, c1, !swapped, depth + 1);
+    } else {
+        double mid = (b0 + b1) * 0.5;
+        split_segment(&b, 0.5, &left, &right);
+        clip_pair(ctx, left, b0, mid, clipped, c0, c1, !swapped, depth + 1);
+        clip_pair(ctx, right, mid, b1, clipped, c0, c1, !swapped, depth + 1);
+    }
+}
+
+static void begin_pair(ClipContext* ctx, int index_a, int index_b) {
+    ctx->pair_start = ctx->count;
+    ctx->segment_a = index_a;
+    ctx->segment_b = index_b;
+    ctx->budget = CLIP_BUDGET;
+}
+
+static void intersect_pair(ClipContext* ctx, const Segment* a, int index_a, const Segment* b, int index_b) {
+    begin_pair(ctx, index_a, index_b);
+    clip_pair(ctx, *a, 0.0, 1.0, *b, 0.0, 1.0, false, 0);
+}
+
+// Parameter between the two branches of a loop inside one cubic. With the power basis
+// x(t) = a t^3 + b t^2 + c t + d, a double point x(s) = x(t) leaves
+// a (s^2 + st + t^2) + b (s + t) + c = 0, and its cross product with a gives
+// s + t = cross(c, a) / cross(a, b). Without a loop in (0, 1) the midpoint serves.
+static double loop_split(const Segment* segment) {
+    const Point* p = segment->p;
+    Point a = { p[3].x - 3.0 * p[2].x + 3.0 * p[1].x - p[0].x, p[3].y - 3.0 * p[2].y + 3.0 * p[1].y - p[0].y };
+    Point b = { 3.0 * (p[2].x - 2.0 * p[1].x + p[0].x), 3.0 * (p[2].y - 2.0 * p[1].y + p[0].y) };
+    Point c = { 3.0 * (p[1].x - p[0].x), 3.0 * (p[1].y - p[0].y) };
+    double split = 0.5 * (c.x * a.y - a.x * c.y) / (a.x * b.y - b.x * a.y);
+    return split > 0.0 && split < 1.0 ? split : 0.5;
+}
+
+// A single cubic can cross itself. Its halves, split between the branches of a possible
+// loop, are clipped against each other in the parameters of the whole segment; the point
+// where the halves meet is dropped like the joint of two neighbours.
+static void intersect_loop(ClipContext* ctx, const Segment* segment, int index) {
+    double split = loop_split(segment);
+    Segment left, right;
+    split_segment(segment, split, &left, &right);
+    begin_pair(ctx, index, index);
+    int before = ctx->count;
+    clip_pair(ctx, left, 0.0, split, right, split, 1.0, false, 0);
+    int kept = before;
+    for (int h = before; h < ctx->count; ++h) {
+        if (ctx->out[h].t_a < split - ENDPOINT_PARAMETER || ctx->out[h].t_b > split + ENDPOINT_PARAMETER) {
+            ctx->out[kept++] = ctx->out[h];
+        }
+    }
+    ctx->count = kept;
+}
+
+static int compare_min_x(const void* lhs, const void* rhs) {
+    double a = ((const BoxEntry*)lhs)->min.x;
+    double b = ((const BoxEntry*)rhs)->min.x;
+    return (a > b) - (a < b);
+}
+
+// Keeps the entries of `active` that still reach x; the rest can never overlap later boxes
+static int prune_active(const BoxEntry entries[], int active[], int n_active, double x) {
+    int kept = 0;
+    for (int k = 0; k < n_active; ++k) {
+        if (entries[active[k]].max.x >= x) {
+            active[kept++] = active[k];
+        }
+    }
+    return kept;
+}
+
+static bool same_point(Point p, Point q) {
+    double dx = p.x - q.x, dy = p.y - q.y;
+    return dx * dx + dy * dy < DUPLICATE_DISTANCE * DUPLICATE_DISTANCE;
+}
+
+// Sweep and prune over the segment boxes sorted by min x. With b == NULL the curve is tested
+// against itself, each segment for a loop of its own too, skipping hits where two segments
+// meet end to start. Which segments meet is read from their endpoints, so the chain may
+// run in either direction.
+static int sweep(const Segment a[], int count_a, const Segment b[], int count_b, Intersection out[], int max_out) {
+    bool self = b == NULL;
+    int total = self ? count_a : count_a + count_b;
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    BoxEntry* entries = arena_alloc(scratch, total * sizeof(BoxEntry));
+    int* active = arena_alloc(scratch, 2 * total * sizeof(int));
+    if (entries == NULL || active == NULL) {
+        arena_release(scratch, mark);
+        return 0;
+    }
+    for (int i = 0; i < total; ++i) {
+        int set = i < count_a ? 0 : 1;
+        entries[i].index = set == 0 ? i : i - count_a;
+        entries[i].set = set;
+        segment_bounds(set == 0 ? &a[entries[i].index] : &b[entries[i].index], &entries[i].min, &entries[i].max);
+    }
+    qsort(entries, total, sizeof(BoxEntry), compare_min_x);
+
+    ClipContext ctx = { out, max_out, 0, 0, 0, 0, 0 };
+    int* active_sets[2] = { active, active + total };
+    int n_active[2] = { 0, 0 };
+    for (int e = 0; e < total && ctx.count < max_out; ++e) {
+        const BoxEntry* entry = &entries[e];
+        if (self) {
+            intersect_loop(&ctx, &a[entry->index], entry->index);
+        }
+        int other = self ? 0 : 1 - entry->set;
+        n_active[other] = prune_active(entries, active_sets[other], n_active[other], entry->min.x);
+        for (int k = 0; k < n_active[other]; ++k) {
+            const BoxEntry* candidate = &entries[active_sets[other][k]];
+            if (candidate->min.y > entry->max.y || entry->min.y > candidate->max.y) {
+                continue;
+            }
+            if (self) {
+                int i = candidate->index < entry->index ? candidate->index : entry->index;
+                int j = candidate->index < entry->index ? entry->index : candidate->index;
+                int before = ctx.count;
+                intersect_pair(&ctx, &a[i], i, &a[j], j);
+                // Neighbours always meet at their common endpoint; that is not a crossing
+                bool i_to_j = same_point(a[i].p[3], a[j].p[0]);
+                bool j_to_i = same_point(a[j].p[3], a[i].p[0]);
+                if (i_to_j || j_to_i) {
+                    int kept = before;
+                    for (int h = before; h < ctx.count; ++h) {
+                        double t_a = out[h].t_a, t_b = out[h].t_b;
+                        bool joint = (i_to_j && t_a > 1.0 - ENDPOINT_PARAMETER && t_b < ENDPOINT_PARAMETER) ||
+                                     (j_to_i && t_a < ENDPOINT_PARAMETER && t_b > 1.0 - ENDPOINT_PARAMETER);
+                        if (!joint) {
+                            out[kept++] = out[h];
+                        }
+                    }
+                    ctx.count = kept;
+                }
+            } else if (entry->set == 0) {
+                intersect_pair(&ctx, &a[entry->index], entry->index, &b[candidate->index], candidate->index);
+            } else {
+                intersect_pair(&ctx, &a[candidate->index], candidate->index, &b[entry->index], entry->index);
+            }
+        }
+        int own = self ? 0 : entry->set;
+        active_sets[own][n_active[own]++] = e;
+    }
+
+    arena_release(scratch, mark);
+    return ctx.count;
+}
+
+int intersect_curves(const Segment a[], int count_a, const Segment b[], int count_b,
+                     Intersection out[], int max_out) {
+    return sweep(a, count_a, b, count_b, out, max_out);
+}
+
+// Every pair tested directly; kept as the reference for the sweep in benchmarks
+int intersect_curves_brute_force(const Segment a[], int count_a, const Segment b[], int count_b,
+                                 Intersection out[], int max_out) {
+    ClipContext ctx = { out, max_out, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < count_a; ++i) {
+        for (int j = 0; j < count_b; ++j) {
+            intersect_pair(&ctx, &a[i], i, &b[j], j);
+        }
+    }
+    return ctx.count;
+}
+
+// The line is a cubic with evenly spaced control points, so its parameter stays linear
+int intersect_curve_line(const Segment a[], int count_a, Point l0, Point l1,
+                         Intersection out[], int max_out) {
+    Segment line = { {
+        l0,
+        { l0.x + (l1.x - l0.x) / 3.0, l0.y + (l1.y - l0.y) / 3.0 },
+        { l0.x + (l1.x - l0.x) * 2.0 / 3.0, l0.y + (l1.y - l0.y) * 2.0 / 3.0 },
+        l1
+    } };
+    int count = sweep(a, count_a, &line, 1, out, max_out);
+    for (int i = 0; i < count; ++i) {
+        out[i].segment_b = -1;
+    }
+    return count;
+}
+
+int intersect_self(const Segment segments[], int count, Intersection out[], int max_out) {
+    return sweep(segments, count, NULL, 0, out, max_out);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "types.h"
+
+typedef struct Intersection {
+    int segment_a;      // segment index on the first curve
+    int segment_b;      // segment index on the second curve, -1 for a line
+    double t_a;         // local parameter on segment_a
+    double t_b;         // local parameter on segment_b, or on the line from l0 to l1
+    Point point;
+} Intersection;
+
+int intersect_curves(const Segment a[], int count_a, const Segment b[], int count_b,
+                     Intersection out[], int max_out);
+int intersect_curves_brute_force(const Segment a[], int count_a, const Segment b[], int count_b,
+                                 Intersection out[], int max_out);
+int intersect_curve_line(const Segment a[], int count_a, Point l0, Point l1,
+                         Intersection out[], int max_out);
+int intersect_self(const Segment segments[], int count, Intersection out[], int max_out);
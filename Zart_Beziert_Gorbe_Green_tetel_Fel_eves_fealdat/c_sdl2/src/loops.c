@@ -0,0 +1,334 @@
+#include "loops.h"
+#include "arena.h"
+#include "bezier.h"
+#include "profile.h"
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct EdgeBox {
+    double min_x, max_x, min_y, max_y;
+    int index;
+} EdgeBox;
+
+typedef struct Crossing {
+    int edge;
+    double t;       // position along the edge, orders crossings on the same edge
+    int id;         // both edges of a crossing share the id
+} Crossing;
+
+typedef struct StackEntry {
+    Point point;
+    double prefix;  // twice the shoelace sum from the stack bottom up to this point
+    int crossing;   // crossing id, -1 for plain vertices
+} StackEntry;
+
+typedef struct Hit {
+    int i, j;       // crossing edges
+    double s, u;    // positions along them
+    Point point;
+} Hit;
+
+typedef struct SlabEdge {
+    double x0, x1;  // x at the bottom and the top of the slab
+    int winding;    // +1 going up in y, -1 going down
+} SlabEdge;
+
+static int compare_min_x(const void* lhs, const void* rhs) {
+    double a = ((const EdgeBox*)lhs)->min_x;
+    double b = ((const EdgeBox*)rhs)->min_x;
+    return (a > b) - (a < b);
+}
+
+static int compare_min_y(const void* lhs, const void* rhs) {
+    double a = ((const EdgeBox*)lhs)->min_y;
+    double b = ((const EdgeBox*)rhs)->min_y;
+    return (a > b) - (a < b);
+}
+
+static int compare_double(const void* lhs, const void* rhs) {
+    double a = *(const double*)lhs;
+    double b = *(const double*)rhs;
+    return (a > b) - (a < b);
+}
+
+static int compare_crossing(const void* lhs, const void* rhs) {
+    const Crossing* a = lhs;
+    const Crossing* b = rhs;
+    if (a->edge != b->edge) {
+        return a->edge - b->edge;
+    }
+    return (a->t > b->t) - (a->t < b->t);
+}
+
+static double cross(Point a, Point b) {
+    return a.x * b.y - b.x * a.y;
+}
+
+// Proper crossing of p0-p1 and q0-q1; touching and collinear cases do not count
+static bool edge_crossing(Point p0, Point p1, Point q0, Point q1, double* s, double* u) {
+    double rx = p1.x - p0.x, ry = p1.y - p0.y;
+    double qx = q1.x - q0.x, qy = q1.y - q0.y;
+    double denom = rx * qy - ry * qx;
+    if (denom == 0.0) {
+        return false;
+    }
+    double wx = q0.x - p0.x, wy = q0.y - p0.y;
+    *s = (wx * qy - wy * qx) / denom;
+    *u = (wx * ry - wy * rx) / denom;
+    return *s > 0.0 && *s < 1.0 && *u > 0.0 && *u < 1.0;
+}
+
+// Sweep over the edge boxes sorted by min x; returns the number of crossings or -1.
+// The hit list is the newest scratch allocation while it grows, so it extends in place.
+static int find_crossings(Arena* scratch, const Point polyline[], int count, Hit** hits_out) {
+    EdgeBox* boxes = arena_alloc(scratch, count * sizeof(EdgeBox));
+    int* active = arena_alloc(scratch, count * sizeof(int));
+    int capacity = 64;
+    Hit* hits = arena_alloc(scratch, capacity * sizeof(Hit));
+    if (boxes == NULL || active == NULL || hits == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < count; ++i) {
+        Point a = polyline[i];
+        Point b = polyline[(i + 1) % count];
+        boxes[i].min_x = fmin(a.x, b.x);
+        boxes[i].max_x = fmax(a.x, b.x);
+        boxes[i].min_y = fmin(a.y, b.y);
+        boxes[i].max_y = fmax(a.y, b.y);
+        boxes[i].index = i;
+    }
+    qsort(boxes, count, sizeof(EdgeBox), compare_min_x);
+
+    // active holds the sorted slots whose box still reaches the sweep position
+    int n_active = 0;
+    int found = 0;
+    for (int e = 0; e < count; ++e) {
+        const EdgeBox* box = &boxes[e];
+        int kept = 0;
+        for (int k = 0; k < n_active; ++k) {
+            if (boxes[active[k]].max_x >= box->min_x) {
+                active[kept++] = active[k];
+            }
+        }
+        n_active = kept;
+
+        for (int k = 0; k < n_active; ++k) {
+            const EdgeBox* other = &boxes[active[k]];
+            if (other->min_y > box->max_y || box->min_y > other->max_y) {
+                continue;
+            }
+            int i = box->index, j = other->index;
+            int gap = abs(i - j);
+            if (gap == 1 || gap == count - 1) {
+                continue;   // neighbours share a vertex
+            }
+            double s, u;
+            if (!edge_crossing(polyline[i], polyline[(i + 1) % count], polyline[j], polyline[(j + 1) % count], &s, &u)) {
+                continue;
+            }
+            if (found == capacity) {
+                hits = arena_realloc(scratch, hits, capacity * sizeof(Hit), 2 * capacity * sizeof(Hit));
+                if (hits == NULL) {
+                    return -1;
+                }
+                capacity *= 2;
+            }
+            Point point = {
+                polyline[i].x + (polyline[(i + 1) % count].x - polyline[i].x) * s,
+                polyline[i].y + (polyline[(i + 1) % count].y - polyline[i].y) * s,
+            };
+            hits[found++] = (Hit){ i, j, s, u, point };
+        }
+        active[n_active++] = e;
+    }
+    *hits_out = hits;
+    return found;
+}
+
+// Area of the points with nonzero winding number. Slabs end at the next vertex or crossing
+// height, so no two edges cross inside one: sorted by x, consecutive edges bound exact
+// trapezoids, which count where the running winding is not zero. Coordinates are taken
+// relative to origin, like the loop walk. Returns -1 when out of memory.
+static double nonzero_area(Arena* scratch, const Point polyline[], int count, const Hit hits[], int found,
+                           Point origin) {
+    double* crossing_y = arena_alloc(scratch, (found + 1) * sizeof(double));
+    EdgeBox* edges = arena_alloc(scratch, count * sizeof(EdgeBox));
+    int* active = arena_alloc(scratch, count * sizeof(int));
+    SlabEdge* slab = arena_alloc(scratch, count * sizeof(SlabEdge));
+    if (crossing_y == NULL || edges == NULL || active == NULL || slab == NULL) {
+        return -1.0;
+    }
+    for (int i = 0; i < count; ++i) {
+        double a = polyline[i].y - origin.y, b = polyline[(i + 1) % count].y - origin.y;
+        edges[i] = (EdgeBox){ 0.0, 0.0, fmin(a, b), fmax(a, b), i };
+    }
+    for (int c = 0; c < found; ++c) {
+        crossing_y[c] = hits[c].point.y - origin.y;
+    }
+    qsort(edges, count, sizeof(EdgeBox), compare_min_y);
+    qsort(crossing_y, found, sizeof(double), compare_double);
+
+    double area = 0.0;
+    double y0 = edges[0].min_y;
+    int added = 0, n_active = 0, next_crossing = 0;
+    while (true) {
+        while (added < count && edges[added].min_y <= y0) {
+            active[n_active++] = added++;
+        }
+        int kept = 0;
+        double y1 = added < count ? edges[added].min_y : INFINITY;
+        for (int k = 0; k < n_active; ++k) {
+            if (edges[active[k]].max_y > y0) {
+                y1 = fmin(y1, edges[active[k]].max_y);
+                active[kept++] = active[k];
+            }
+        }
+        n_active = kept;
+        if (n_active == 0) {
+            if (added == count) {
+                break;
+            }
+            // Taking the edge right away keeps a NaN height from stalling the sweep
+            y0 = edges[added].min_y;
+            active[n_active++] = added++;
+            continue;
+        }
+        while (next_crossing < found && crossing_y[next_crossing] <= y0) {
+            ++next_crossing;
+        }
+        if (next_crossing < found) {
+            y1 = fmin(y1, crossing_y[next_crossing]);
+        }
+
+        // Every active edge spans [y0, y1]
+        for (int k = 0; k < n_active; ++k) {
+            int i = edges[active[k]].index;
+            Point a = { polyline[i].x - origin.x, polyline[i].y - origin.y };
+            Point b = { polyline[(i + 1) % count].x - origin.x, polyline[(i + 1) % count].y - origin.y };
+            double slope = (b.x - a.x) / (b.y - a.y);
+            SlabEdge edge = { a.x + (y0 - a.y) * slope, a.x + (y1 - a.y) * slope, b.y > a.y ? 1 : -1 };
+            // A slab holds a handful of edges: insertion sort by the x of the slab middle
+            int m = k;
+            for (; m > 0 && slab[m - 1].x0 + slab[m - 1].x1 > edge.x0 + edge.x1; --m) {
+                slab[m] = slab[m - 1];
+            }
+            slab[m] = edge;
+        }
+        int winding = 0;
+        for (int k = 0; k + 1 < n_active; ++k) {
+            winding += slab[k].winding;
+            if (winding != 0) {
+                area += 0.5 * ((slab[k + 1].x0 - slab[k].x0) + (slab[k + 1].x1 - slab[k].x1)) * (y1 - y0);
+            }
+        }
+        y0 = y1;
+    }
+    return area;
+}
+
+static void add_loop(LoopAreas* result, double twice_area) {
+    double area = twice_area / 2.0;
+    if (result->loop_count < MAX_REPORTED_LOOPS) {
+        result->loop_area[result->loop_count] = area;
+    }
+    ++result->loop_count;
+    result->signed_area += area;
+}
+
+// Walks the closed polyline with the crossings spliced in. Reaching a crossing for the
+// second time closes the loop on top of the stack; its area comes from the prefix sums.
+// What is left at the end is the last loop. The loop areas add up to the shoelace area
+// of the whole polyline. The true area is what a nonzero fill covers: opposite lobes do
+// not cancel, and a loop nested in another of the same orientation counts only once.
+bool decompose_loops(const Point polyline[], int count, LoopAreas* result) {
+    result->crossing_count = 0;
+    result->loop_count = 0;
+    result->signed_area = 0.0;
+    result->true_area = 0.0;
+    if (count < 3) {
+        return true;
+    }
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Hit* hits = NULL;
+    int found = find_crossings(scratch, polyline, count, &hits);
+    if (found < 0) {
+        arena_release(scratch, mark);
+        return false;
+    }
+    Crossing* crossings = arena_alloc(scratch, 2 * (found + 1) * sizeof(Crossing));
+    int* first_visit = arena_alloc(scratch, (found + 1) * sizeof(int));
+    StackEntry* stack = arena_alloc(scratch, (count + found + 1) * sizeof(StackEntry));
+    if (crossings == NULL || first_visit == NULL || stack == NULL) {
+        arena_release(scratch, mark);
+        return false;
+    }
+    result->crossing_count = found;
+    Point origin = polyline[0];
+    result->true_area = nonzero_area(scratch, polyline, count, hits, found, origin);
+    if (result->true_area < 0.0) {
+        arena_release(scratch, mark);
+        return false;
+    }
+    for (int c = 0; c < found; ++c) {
+        crossings[2 * c] = (Crossing){ hits[c].i, hits[c].s, c };
+        crossings[2 * c + 1] = (Crossing){ hits[c].j, hits[c].u, c };
+        first_visit[c] = -1;
+    }
+    qsort(crossings, 2 * found, sizeof(Crossing), compare_crossing);
+
+    // Stack points are kept relative to the first vertex, so the cross products do not
+    // cancel far from the origin
+    int top = 0;
+    stack[0] = (StackEntry){ { 0.0, 0.0 }, 0.0, -1 };
+    int next = 0;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            Point vertex = { polyline[i].x - origin.x, polyline[i].y - origin.y };
+            stack[top + 1] = (StackEntry){ vertex, stack[top].prefix + cross(stack[top].point, vertex), -1 };
+            ++top;
+        }
+        for (; next < 2 * found && crossings[next].edge == i; ++next) {
+            int id = crossings[next].id;
+            Point point = { hits[id].point.x - origin.x, hits[id].point.y - origin.y };
+            int k = first_visit[id];
+            if (k >= 0) {
+                add_loop(result, stack[top].prefix - stack[k].prefix + cross(stack[top].point, point));
+                // Crossings popped with the loop get a fresh start on their next visit
+                for (int m = k + 1; m <= top; ++m) {
+                    if (stack[m].crossing >= 0) {
+                        first_visit[stack[m].crossing] = -1;
+                    }
+                }
+                top = k;
+                first_visit[id] = -1;
+                stack[top].crossing = -1;
+            } else {
+                stack[top + 1] = (StackEntry){ point, stack[top].prefix + cross(stack[top].point, point), id };
+                ++top;
+                first_visit[id] = top;
+            }
+        }
+    }
+    add_loop(result, stack[top].prefix);
+    arena_release(scratch, mark);
+    return true;
+}
+
+// Loop decomposition of the closed curve drawn by the control points
+double outline_true_area(Point points[], int steps, LoopAreas* result) {
+    PROFILE_SCOPE("outline_true_area");
+    int count = N_POINTS * steps;
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Point* outline = arena_alloc(scratch, count * sizeof(Point));
+    if (outline == NULL) {
+        return -1.0;
+    }
+    Segment segments[N_POINTS];
+    build_segments(points, N_POINTS, segments);
+    tessellate_outline(segments, N_POINTS, steps, outline);
+    bool ok = decompose_loops(outline, count, result);
+    arena_release(scratch, mark);
+    return ok ? result->true_area : -1.0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+
+#define MAX_REPORTED_LOOPS 32
+
+typedef struct LoopAreas {
+    int crossing_count;
+    int loop_count;
+    double loop_area[MAX_REPORTED_LOOPS];   // signed shoelace area of the first loops
+    double signed_area;                     // sum of the loops, what calculate_area() sees
+    double true_area;                       // where the winding number is not zero
+} LoopAreas;
+
+bool decompose_loops(const Point polyline[], int count, LoopAreas* result);
+double outline_true_area(Point points[], int steps, LoopAreas* result);
@@ -2,10 +2,21 @@
 #include "bezier.h"
 #include "area.h"
 #include "utils.h"
+#include "bench.h"
+#include "loops.h"
+#include "stream.h"
+#include "trace.h"
+#include "profile.h"
+#include "pipeline.h"
+#include "arena.h"
+#include "simplify.h"
+#include "stress.h"
+#include "verify.h"
 #include <stdio.h>   // printf, fflush, stdout
 #include <math.h>    // sqrt
 #include <SDL2/SDL.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 int main(int argc, char* argv[]) {
@@ -16,11 +27,53 @@ int main(int argc, char* argv[]) {
     int mouse_x, mouse_y;
     int steps = 100;
     double approximation_error = 0.0;
+    double area = 0.0;
+    bool area_changed = false;
+    bool loop_mode = false;
+    LoopAreas loops = { 0 };
+    Moments moments = { 0 };
+    bool use_pipeline = false;
+    bool thick_stroke = false;
+    bool comb_mode = false;
+    Precision precision = PRECISION_DOUBLE;
+    unsigned shown_generation = 0;
 
     Point points[N_POINTS] = {
         {200, 200}, {400, 200}, {400, 400}, {200, 400}
     };
     Point last_points[N_POINTS];
+    TraceWriter trace = { 0 };
+
+    // Headless modes
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return run_benchmarks();
+    }
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        return run_verification();
+    }
+    if (argc > 1 && strcmp(argv[1], "--stress") == 0) {
+        return run_stress(argc > 2 ? atoi(argv[2]) : STRESS_DEFAULT_ROUNDS);
+    }
+    if (argc > 3 && strcmp(argv[1], "--import") == 0) {
+        return import_csv(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc > 3 && strcmp(argv[1], "--simplify") == 0) {
+        return simplify_file(argv[2], argv[3], argc > 4 ? atof(argv[4]) : 0.5);
+    }
+    if (argc > 3 && strcmp(argv[1], "--curvature") == 0) {
+        return export_curvature(argv[2], argv[3], argc > 4 ? atoi(argv[4]) : 16);
+    }
+    if (argc > 2 && strcmp(argv[1], "--stream") == 0) {
+        return stream_file(argv[2]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        return replay_trace(argv[2]);
+    }
+    // Interactive session continuing from where a recorded trace ended
+    if (argc > 2 && strcmp(argv[1], "--restore") == 0 && !trace_final_points(argv[2], points, &steps)) {
+        printf("Hiba: %s nem olvashato nyomvonal\n", argv[2]);
+        return 1;
+    }
     memcpy(last_points, points, sizeof(points));
 
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
@@ -28,12 +81,31 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    window = SDL_CreateWindow("Zárt Bézier-görbe", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, 0);
+    window = SDL_CreateWindow("Zárt Bézier-görbe", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (!graphics_init(renderer)) {
+        printf("Grafikai inicializalasi hiba: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (argc > 2 && strcmp(argv[1], "--record") == 0 && !trace_begin(&trace, argv[2], points, steps)) {
+        printf("Hiba: %s nem irhato\n", argv[2]);
+    }
+    // Tessellation and area run on worker threads; without them everything stays inline
+    use_pipeline = pipeline_start(steps);
+    if (use_pipeline) {
+        pipeline_submit(points);
+    } else {
+        printf("Munkaszalak nem indultak, szamolas a fo szalon\n");
+    }
 
     bool need_run = true;
     while (need_run) {
+        PROFILE_FRAME();
+        // Scratch memory of the previous frame is dead by now
+        arena_reset(scratch_arena());
+        PROFILE_BEGIN("events");
         while (SDL_PollEvent(&event)) {
+            PROFILE_COUNT(PROFILE_EVENTS, 1);
             switch (event.type) {
                 case SDL_MOUSEBUTTONDOWN:
                     SDL_GetMouseState(&mouse_x, &mouse_y);
@@ -56,19 +128,61 @@ int main(int argc, char* argv[]) {
                         SDL_GetMouseState(&mouse_x, &mouse_y);
                         selected_point->x = mouse_x;
                         selected_point->y = mouse_y;
+                        trace_record(&trace, (int)(selected_point - points), mouse_x, mouse_y);
 
                         if (points_changed(last_points, points)) {
-                            double area = calculate_area(points, steps, &approximation_error);
-                            save_area_to_file(area, approximation_error);
+                            if (use_pipeline) {
+                                pipeline_submit(points);
+                            } else {
+                                area = calculate_area_precision(points, steps, precision, &approximation_error);
+                                calculate_moments(points, &moments);
+                                save_area_to_file(area, approximation_error, &moments);
+                            }
+                            if (loop_mode && outline_true_area(points, steps, &loops) >= 0.0) {
+                                save_loops_to_file(&loops);
+                            }
                             memcpy(last_points, points, sizeof(points));
-                            printf("\rTerulet: %.2f    Hiba: %.5f       ", area, approximation_error);
-                            fflush(stdout);
+                            area_changed = true;
                         }
                     }
                     break;
                 case SDL_KEYDOWN:
                     if (event.key.keysym.sym == SDLK_q) {
                         need_run = false;
+                    } else if (event.key.keysym.sym == SDLK_l) {
+                        // Loop mode: split the curve at its self-intersections
+                        loop_mode = !loop_mode;
+                        if (loop_mode) {
+                            outline_true_area(points, steps, &loops);
+                        }
+                        area_changed = true;
+                    } else if (event.key.keysym.sym == SDLK_w) {
+                        // Switch between the worker pipeline and inline computation
+                        if (use_pipeline) {
+                            pipeline_stop();
+                            use_pipeline = false;
+                        } else if (pipeline_start(steps)) {
+                            use_pipeline = true;
+                            shown_generation = 0;
+                            pipeline_submit(points);
+                        }
+                        printf("\n%s\n", use_pipeline ? "Munkaszalas szamolas" : "Szamolas a fo szalon");
+                    } else if (event.key.keysym.sym == SDLK_f) {
+                        // Float32 tessellation for drawing and the inline area
+                        precision = precision == PRECISION_DOUBLE ? PRECISION_FLOAT : PRECISION_DOUBLE;
+                        graphics_set_precision(precision);
+                        printf("\nPontossag: %s\n", precision == PRECISION_FLOAT ? "float" : "double");
+                    } else if (event.key.keysym.sym == SDLK_v) {
+                        // Thick stroke around the curve, with the area of the band
+                        thick_stroke = !thick_stroke;
+                        graphics_set_stroke(thick_stroke ? STROKE_HALF_WIDTH : 0.0);
+                        area_changed = true;
+                    } else if (event.key.keysym.sym == SDLK_c) {
+                        // Curvature comb along the curve
+                        comb_mode = !comb_mode;
+                        graphics_set_comb(comb_mode);
+                    } else if (event.key.keysym.sym == SDLK_F3) {
+                        PROFILE_TOGGLE_OVERLAY();
                     }
                     break;
                 case SDL_QUIT:
@@ -76,11 +190,48 @@ int main(int argc, char* argv[]) {
                     break;
             }
         }
+        PROFILE_END();
 
-        render_scene(renderer, points, steps);
+        // The newest finished geometry; the UI never waits for a running job
+        const Geometry* geometry = use_pipeline ? pipeline_latest() : NULL;
+        if (geometry != NULL && geometry->generation != shown_generation) {
+            shown_generation = geometry->generation;
+            area = geometry->area;
+            approximation_error = geometry->error;
+            calculate_moments(geometry->points, &moments);
+            save_area_to_file(area, approximation_error, &moments);
+            area_changed = true;
+        }
+        long pixel_area = geometry != NULL ? render_geometry(renderer, points, geometry->polyline, steps)
+                                           : render_scene(renderer, points, steps);
+        PROFILE_DRAW_OVERLAY(window, renderer);
+        SDL_RenderPresent(renderer);
+        if (area_changed) {
+            // The raster count cross-checks the analytic area
+            printf("\rTerulet: %.2f    Hiba: %.5f    Pixel terulet: %ld    Sulypont: (%.1f, %.1f)",
+                   area, approximation_error, pixel_area, moments.centroid.x, moments.centroid.y);
+            if (loop_mode) {
+                printf("    Metszespontok: %d    Hurkok: %d    Valodi terulet: %.2f",
+                       loops.crossing_count, loops.loop_count, loops.true_area);
+            }
+            if (thick_stroke) {
+                printf("    Sav terulet: %.2f", graphics_stroke_area());
+            }
+            printf("       ");
+            fflush(stdout);
+            area_changed = false;
+        }
         SDL_Delay(16);
     }
 
+    if (use_pipeline) {
+        pipeline_stop();
+    }
+    trace_end(&trace);
+    PROFILE_EXPORT("profile_trace.json");
+    graphics_shutdown();
+    arena_print_stats(scratch_arena(), "\nKeret memoria");
+    scratch_arena_shutdown();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,317 @@
+#include "offset.h"
+#include "area.h"
+#include "arena.h"
+#include "bezier.h"
+#include "intersect.h"
+#include "profile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OFFSET_MAX_DEPTH 10
+#define OFFSET_MAX_PIECES (1 << OFFSET_MAX_DEPTH)
+#define MITER_LIMIT 4.0             // miter length over half width before falling back to bevel
+#define SMOOTH_JOIN_SIN 1e-3        // tangent turns smaller than this need no join
+
+static Point add(Point a, Point b) {
+    Point p = { a.x + b.x, a.y + b.y };
+    return p;
+}
+
+static Point sub(Point a, Point b) {
+    Point p = { a.x - b.x, a.y - b.y };
+    return p;
+}
+
+static Point scale(Point a, double s) {
+    Point p = { a.x * s, a.y * s };
+    return p;
+}
+
+static double dot(Point a, Point b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+static double cross(Point a, Point b) {
+    return a.x * b.y - b.x * a.y;
+}
+
+static Point unit(Point a) {
+    double length = sqrt(dot(a, a));
+    return length > 0.0 ? scale(a, 1.0 / length) : a;
+}
+
+static Point left_normal(Point tangent) {
+    Point n = { -tangent.y, tangent.x };
+    return n;
+}
+
+// Unit tangent at an end; coincident control points fall back to the next one along
+static Point end_tangent(const Segment* s, bool at_end) {
+    const Point* p = s->p;
+    Point d = at_end ? sub(p[3], p[2]) : sub(p[1], p[0]);
+    if (dot(d, d) == 0.0) d = at_end ? sub(p[3], p[1]) : sub(p[2], p[0]);
+    if (dot(d, d) == 0.0) d = sub(p[3], p[0]);
+    return unit(d);
+}
+
+static Point derivative(const Point p[4], double t) {
+    double u = 1.0 - t;
+    Point d = {
+        3 * (u * u * (p[1].x - p[0].x) + 2 * u * t * (p[2].x - p[1].x) + t * t * (p[3].x - p[2].x)),
+        3 * (u * u * (p[1].y - p[0].y) + 2 * u * t * (p[2].y - p[1].y) + t * t * (p[3].y - p[2].y)),
+    };
+    return d;
+}
+
+static Point second_derivative(const Point p[4], double t) {
+    double u = 1.0 - t;
+    Point d = {
+        6 * (u * (p[2].x - 2 * p[1].x + p[0].x) + t * (p[3].x - 2 * p[2].x + p[1].x)),
+        6 * (u * (p[2].y - 2 * p[1].y + p[0].y) + t * (p[3].y - 2 * p[2].y + p[1].y)),
+    };
+    return d;
+}
+
+static Point offset_point(const Segment* s, double distance, double t) {
+    Point d = derivative(s->p, t);
+    if (dot(d, d) == 0.0) {
+        d = t < 0.5 ? end_tangent(s, false) : end_tangent(s, true);
+    }
+    return add(bezier(s->p[0], s->p[1], s->p[2], s->p[3], t), scale(left_normal(unit(d)), distance));
+}
+
+// End points move along the normals and keep their tangents. The handles scale with the
+// speed of the offset, |C'|(1 - d k), which is what keeps the parameterization close to
+// the original one so the error check can compare equal parameters.
+static Segment approximate_offset(const Segment* s, double distance) {
+    const Point* p = s->p;
+    Segment out;
+    for (int end = 0; end < 2; ++end) {
+        double t = end;
+        Point tangent = end_tangent(s, end == 1);
+        Point d1 = derivative(p, t);
+        double speed = sqrt(dot(d1, d1));
+        double factor = 1.0;
+        if (speed > 0.0) {
+            double curvature = cross(d1, second_derivative(p, t)) / (speed * speed * speed);
+            factor = fmax(0.0, 1.0 - distance * curvature);
+        }
+        Point corner = add(p[3 * end], scale(left_normal(tangent), distance));
+        Point handle = scale(tangent, speed / 3.0 * factor);
+        if (end == 0) {
+            out.p[0] = corner;
+            out.p[1] = add(corner, handle);
+        } else {
+            out.p[3] = corner;
+            out.p[2] = sub(corner, handle);
+        }
+    }
+    return out;
+}
+
+static double offset_error(const Segment* s, double distance, const Segment* approx) {
+    static const double samples[3] = { 0.25, 0.5, 0.75 };
+    double worst = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        const Point* q = approx->p;
+        Point diff = sub(bezier(q[0], q[1], q[2], q[3], samples[k]), offset_point(s, distance, samples[k]));
+        worst = fmax(worst, sqrt(dot(diff, diff)));
+    }
+    return worst;
+}
+
+static int offset_piece(const Segment* s, double distance, double tolerance, Segment out[], int max_out, int depth) {
+    if (max_out < 1) {
+        return -1;
+    }
+    Segment approx = approximate_offset(s, distance);
+    if (depth >= OFFSET_MAX_DEPTH || offset_error(s, distance, &approx) <= tolerance) {
+        out[0] = approx;
+        return 1;
+    }
+    Segment left, right;
+    split_segment(s, 0.5, &left, &right);
+    int first = offset_piece(&left, distance, tolerance, out, max_out, depth + 1);
+    if (first < 0) {
+        return -1;
+    }
+    int second = offset_piece(&right, distance, tolerance, out + first, max_out - first, depth + 1);
+    return second < 0 ? -1 : first + second;
+}
+
+// Cubics within tolerance of the curve offset by distance along its left normal. Returns the
+// number of pieces, or -1 when max_out is too small.
+int offset_segment(const Segment* segment, double distance, double tolerance, Segment out[], int max_out) {
+    return offset_piece(segment, distance, tolerance, out, max_out, 0);
+}
+
+static Segment line_segment(Point a, Point b) {
+    Segment s = { { a, add(a, scale(sub(b, a), 1.0 / 3.0)), add(a, scale(sub(b, a), 2.0 / 3.0)), b } };
+    return s;
+}
+
+// Outer join around corner from a to b, both at |distance| from it. Returns the segment count.
+static int join_segments(Point corner, Point a, Point b, double distance, JoinStyle join, Segment out[4]) {
+    Point na = unit(sub(a, corner)), nb = unit(sub(b, corner));
+    if (join == JOIN_MITER) {
+        double cos_half2 = 0.5 * (1.0 + dot(na, nb));    // cos^2 of half the turn
+        if (cos_half2 > 1.0 / (MITER_LIMIT * MITER_LIMIT)) {
+            Point tip = add(corner, scale(add(na, nb), fabs(distance) / (2.0 * cos_half2)));
+            out[0] = line_segment(a, tip);
+            out[1] = line_segment(tip, b);
+            return 2;
+        }
+    } else if (join == JOIN_ROUND) {
+        // Circular arc in pieces of at most a quarter turn, handles 4/3 tan(angle / 4)
+        double sweep = atan2(cross(na, nb), dot(na, nb));
+        int pieces = (int)ceil(fabs(sweep) / (0.5 * M_PI));
+        if (pieces < 1) pieces = 1;
+        double step = sweep / pieces, radius = fabs(distance);
+        double handle = 4.0 / 3.0 * tan(step / 4.0) * radius;
+        double angle = atan2(na.y, na.x);
+        for (int i = 0; i < pieces; ++i) {
+            double a0 = angle + i * step, a1 = a0 + step;
+            Point u0 = { cos(a0), sin(a0) }, u1 = { cos(a1), sin(a1) };
+            out[i].p[0] = add(corner, scale(u0, radius));
+            out[i].p[3] = add(corner, scale(u1, radius));
+            out[i].p[1] = add(out[i].p[0], scale(left_normal(u0), handle));
+            out[i].p[2] = sub(out[i].p[3], scale(left_normal(u1), handle));
+        }
+        out[0].p[0] = a;
+        out[pieces - 1].p[3] = b;
+        return pieces;
+    }
+    out[0] = line_segment(a, b);
+    return 1;
+}
+
+static bool reserve_side(Stroke* stroke, int side, int needed) {
+    if (needed <= stroke->capacities[side]) {
+        return true;
+    }
+    int size = stroke->capacities[side] > 0 ? stroke->capacities[side] : 64;
+    while (size < needed) {
+        size *= 2;
+    }
+    Segment* grown = realloc(stroke->sides[side], size * sizeof(Segment));
+    if (grown == NULL) {
+        return false;
+    }
+    stroke->sides[side] = grown;
+    stroke->capacities[side] = size;
+    return true;
+}
+
+// On the inside of a corner the two offsets overlap; cut both back to where they cross so
+// the side stays a single loop
+static void trim_inner(Segment* before, Segment* after) {
+    Intersection hit;
+    if (intersect_curves(before, 1, after, 1, &hit, 1) == 1) {
+        *before = sub_segment(before, 0.0, hit.t_a);
+        *after = sub_segment(after, hit.t_b, 1.0);
+        before->p[3] = after->p[0] = hit.point;
+    }
+}
+
+static bool build_side(Stroke* stroke, int side, const Segment chain[], int count, double distance,
+                       JoinStyle join, double tolerance) {
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    int* first = arena_alloc(scratch, (count + 1) * sizeof(int));
+    Segment* pieces = arena_alloc(scratch, (size_t)count * OFFSET_MAX_PIECES * sizeof(Segment));
+    if (first == NULL || pieces == NULL) {
+        arena_release(scratch, mark);
+        return false;
+    }
+    first[0] = 0;
+    for (int i = 0; i < count; ++i) {
+        int n = offset_segment(&chain[i], distance, tolerance, pieces + first[i], OFFSET_MAX_PIECES);
+        first[i + 1] = first[i] + n;
+    }
+
+    int total = 0;
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) {
+        int next = (i + 1) % count;
+        Point t_in = end_tangent(&chain[i], true), t_out = end_tangent(&chain[next], false);
+        double turn = cross(t_in, t_out);
+        bool corner = fabs(turn) > SMOOTH_JOIN_SIN || dot(t_in, t_out) < 0.0;
+        // Turning left puts the left side (positive distance) on the inside
+        bool inner = corner && turn * distance > 0.0;
+        Segment* before = &pieces[first[i + 1] - 1];
+        Segment* after = &pieces[first[next]];
+        if (inner) {
+            trim_inner(before, after);
+        }
+        Segment joint[4];
+        int joint_count = 0;
+        if (corner && !inner) {
+            joint_count = join_segments(chain[i].p[3], before->p[3], after->p[0], distance, join, joint);
+        }
+        int n = first[i + 1] - first[i];
+        ok = reserve_side(stroke, side, total + n + joint_count);
+        if (ok) {
+            memcpy(stroke->sides[side] + total, pieces + first[i], n * sizeof(Segment));
+            memcpy(stroke->sides[side] + total + n, joint, joint_count * sizeof(Segment));
+            total += n + joint_count;
+        }
+    }
+    // The first piece may have been trimmed by the last corner after it was copied
+    if (ok && total > 0) {
+        stroke->sides[side][0] = pieces[0];
+    }
+    arena_release(scratch, mark);
+    stroke->counts[side] = ok ? total : 0;
+    return ok;
+}
+
+// Stroke of a closed chain in which each segment starts where the previous one ends.
+// The band area is the difference of the signed Green's theorem areas of the two sides,
+// so like calculate_area() it counts overlapping parts of the band by winding; lobes of
+// a self-intersecting curve that turn the other way still add up.
+bool stroke_build(Stroke* stroke, const Segment chain[], int count, double half_width, JoinStyle join,
+                  double tolerance) {
+    PROFILE_SCOPE("stroke_build");
+    stroke->valid = false;
+    if (!build_side(stroke, 0, chain, count, half_width, join, tolerance) ||
+        !build_side(stroke, 1, chain, count, -half_width, join, tolerance)) {
+        return false;
+    }
+    Moments left, right;
+    segment_moments(stroke->sides[0], stroke->counts[0], &left);
+    segment_moments(stroke->sides[1], stroke->counts[1], &right);
+    stroke->band_area = fabs(left.signed_area - right.signed_area);
+    stroke->half_width = half_width;
+    stroke->join = join;
+    stroke->tolerance = tolerance;
+    stroke->valid = true;
+    ++stroke->rebuilds;
+    return true;
+}
+
+// Cached stroke of the control point curve. The segments are walked backwards, in the
+// same order as tessellate_outline(), so that each one starts where the previous ends.
+bool stroke_update(Stroke* stroke, const Point points[], double half_width, JoinStyle join, double tolerance) {
+    if (stroke->valid && stroke->half_width == half_width && stroke->join == join &&
+        stroke->tolerance == tolerance && memcmp(stroke->key, points, sizeof(stroke->key)) == 0) {
+        return true;
+    }
+    _Static_assert(N_POINTS == 4, "the backwards walk needs segments of four points over four points");
+    Segment segments[N_POINTS], chain[N_POINTS];
+    build_segments(points, N_POINTS, segments);
+    for (int k = 0; k < N_POINTS; ++k) {
+        chain[k] = segments[(N_POINTS - k) % N_POINTS];
+    }
+    memcpy(stroke->key, points, sizeof(stroke->key));
+    return stroke_build(stroke, chain, N_POINTS, half_width, join, tolerance);
+}
+
+void stroke_free(Stroke* stroke) {
+    for (int side = 0; side < 2; ++side) {
+        free(stroke->sides[side]);
+        stroke->sides[side] = NULL;
+        stroke->counts[side] = stroke->capacities[side] = 0;
+    }
+    stroke->valid = false;
+}
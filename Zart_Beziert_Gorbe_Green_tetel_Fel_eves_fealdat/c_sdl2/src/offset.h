@@ -0,0 +1,31 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+
+typedef enum JoinStyle {
+    JOIN_BEVEL,
+    JOIN_MITER,
+    JOIN_ROUND
+} JoinStyle;
+
+// Both offset sides of the closed curve drawn by the control points. Side 0 lies at
+// +half_width along the left normal, side 1 at -half_width; each is a closed chain of
+// cubics with the joins included. Rebuilt only when the key changes.
+typedef struct Stroke {
+    Point key[N_POINTS];
+    double half_width;
+    JoinStyle join;
+    double tolerance;
+    bool valid;
+    Segment* sides[2];
+    int counts[2];
+    int capacities[2];
+    double band_area;       // area between the two sides, by Green's theorem
+    long rebuilds;
+} Stroke;
+
+int offset_segment(const Segment* segment, double distance, double tolerance, Segment out[], int max_out);
+bool stroke_build(Stroke* stroke, const Segment chain[], int count, double half_width, JoinStyle join,
+                  double tolerance);
+bool stroke_update(Stroke* stroke, const Point points[], double half_width, JoinStyle join, double tolerance);
+void stroke_free(Stroke* stroke);
@@ -0,0 +1,240 @@
+#include "pipeline.h"
+#include "bezier.h"
+#include "power_basis.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WORKERS 8
+#define CANCEL_CHECK_INTERVAL 1024
+#define SLOT_FRESH 4                // set in the handoff state while the middle slot is unread
+
+typedef struct Worker {
+    SDL_Thread* thread;
+    SDL_sem* start;
+    int begin;                      // sample range [begin, end) of the current job
+    int end;
+    double twice_area;
+    double length;
+    bool cancelled;
+} Worker;
+
+// One job is in flight at a time: the coordinator takes the newest snapshot, the workers
+// tessellate disjoint sample ranges of it, and the finished geometry goes through a
+// triple buffer. The UI owns the front slot, the coordinator the back slot, and the
+// third one is exchanged atomically, so neither side ever waits for the other.
+static Geometry slots[3];
+static SDL_atomic_t handoff;        // index of the middle slot | SLOT_FRESH
+static int front = 0;
+static int back = 1;
+
+static SDL_mutex* snapshot_lock = NULL;
+static Point snapshot[N_POINTS];
+static unsigned snapshot_generation = 0;
+static SDL_atomic_t latest_generation;
+static SDL_sem* snapshot_ready = NULL;
+
+static SDL_Thread* coordinator = NULL;
+static SDL_sem* workers_done = NULL;
+static Worker workers[MAX_WORKERS];
+static int worker_count = 0;
+static SDL_atomic_t running;
+
+static int pipeline_steps = 0;
+static Segment job_segments[N_POINTS];
+static PowerBasis job_basis;        // written by the coordinator before the workers start
+static unsigned job_generation = 0;
+static Geometry* job_output = NULL;
+
+static int worker_main(void* data) {
+    Worker* worker = data;
+    int per_segment = pipeline_steps + 1;
+    while (true) {
+        SDL_SemWait(worker->start);
+        if (!SDL_AtomicGet(&running)) {
+            break;
+        }
+        worker->twice_area = 0.0;
+        worker->length = 0.0;
+        worker->cancelled = false;
+        Point prev = { 0.0, 0.0 };
+        for (int k = worker->begin; k < worker->end; ++k) {
+            // A newer snapshot makes this job worthless; give up at the next checkpoint
+            if ((k - worker->begin) % CANCEL_CHECK_INTERVAL == 0 &&
+                (unsigned)SDL_AtomicGet(&latest_generation) != job_generation) {
+                worker->cancelled = true;
+                break;
+            }
+            int segment = k / per_segment;
+            int j = k % per_segment;
+            if (k == worker->begin && j > 0) {
+                prev = power_basis_eval(&job_basis, segment, (double)(j - 1) / pipeline_steps);
+            }
+            Point curr = power_basis_eval(&job_basis, segment, (double)j / pipeline_steps);
+            job_output->polyline[k] = curr;
+            // Same edges as calculate_area(): inside each segment only
+            if (j > 0) {
+                worker->twice_area += prev.x * curr.y - curr.x * prev.y;
+                worker->length += hypot(curr.x - prev.x, curr.y - prev.y);
+            }
+            prev = curr;
+        }
+        SDL_SemPost(workers_done);
+    }
+    return 0;
+}
+
+static void publish(void) {
+    int old = SDL_AtomicSet(&handoff, back | SLOT_FRESH);
+    back = old & ~SLOT_FRESH;
+}
+
+static int coordinator_main(void* data) {
+    (void)data;
+    int count = N_POINTS * (pipeline_steps + 1);
+    while (true) {
+        SDL_SemWait(snapshot_ready);
+        if (!SDL_AtomicGet(&running)) {
+            break;
+        }
+        // Several submissions may have piled up; only the newest one is computed. Draining
+        // before the copy means a submission racing with it still triggers another round.
+        while (SDL_SemTryWait(snapshot_ready) == 0) {
+        }
+        Point points[N_POINTS];
+        SDL_LockMutex(snapshot_lock);
+        memcpy(points, snapshot, sizeof(points));
+        job_generation = snapshot_generation;
+        SDL_UnlockMutex(snapshot_lock);
+
+        build_segments(points, N_POINTS, job_segments);
+        if (!power_basis_update(&job_basis, job_segments, N_POINTS)) {
+            continue;
+        }
+        job_output = &slots[back];
+        for (int w = 0; w < worker_count; ++w) {
+            workers[w].begin = (int)((long)count * w / worker_count);
+            workers[w].end = (int)((long)count * (w + 1) / worker_count);
+            SDL_SemPost(workers[w].start);
+        }
+        double twice_area = 0.0, length = 0.0;
+        bool cancelled = false;
+        for (int w = 0; w < worker_count; ++w) {
+            SDL_SemWait(workers_done);
+        }
+        for (int w = 0; w < worker_count; ++w) {
+            twice_area += workers[w].twice_area;
+            length += workers[w].length;
+            cancelled = cancelled || workers[w].cancelled;
+        }
+        if (cancelled) {
+            continue;
+        }
+        job_output->generation = job_generation;
+        memcpy(job_output->points, points, sizeof(points));
+        job_output->count = count;
+        job_output->area = fabs(twice_area) / 2.0;
+        job_output->error = job_output->area;   // calculate_area() compares against a zero previous area
+        job_output->length = length;
+        publish();
+    }
+    return 0;
+}
+
+bool pipeline_start(int steps) {
+    pipeline_steps = steps;
+    int count = N_POINTS * (steps + 1);
+    for (int i = 0; i < 3; ++i) {
+        slots[i].generation = 0;
+        slots[i].count = 0;
+        slots[i].polyline = malloc(count * sizeof(Point));
+        if (slots[i].polyline == NULL) {
+            pipeline_stop();
+            return false;
+        }
+    }
+    front = 0;
+    back = 1;
+    SDL_AtomicSet(&handoff, 2);
+    SDL_AtomicSet(&latest_generation, 0);
+    SDL_AtomicSet(&running, 1);
+    snapshot_generation = 0;
+
+    // The UI thread keeps one core; the coordinator mostly sleeps
+    worker_count = SDL_GetCPUCount() - 1;
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > MAX_WORKERS) worker_count = MAX_WORKERS;
+    snapshot_lock = SDL_CreateMutex();
+    snapshot_ready = SDL_CreateSemaphore(0);
+    workers_done = SDL_CreateSemaphore(0);
+    if (snapshot_lock == NULL || snapshot_ready == NULL || workers_done == NULL) {
+        pipeline_stop();
+        return false;
+    }
+    for (int w = 0; w < worker_count; ++w) {
+        workers[w].start = SDL_CreateSemaphore(0);
+        workers[w].thread = workers[w].start != NULL ? SDL_CreateThread(worker_main, "tessellate", &workers[w]) : NULL;
+        if (workers[w].thread == NULL) {
+            worker_count = w + (workers[w].start != NULL);
+            pipeline_stop();
+            return false;
+        }
+    }
+    coordinator = SDL_CreateThread(coordinator_main, "pipeline", NULL);
+    if (coordinator == NULL) {
+        pipeline_stop();
+        return false;
+    }
+    return true;
+}
+
+void pipeline_stop(void) {
+    SDL_AtomicSet(&running, 0);
+    if (coordinator != NULL) {
+        SDL_SemPost(snapshot_ready);
+        SDL_WaitThread(coordinator, NULL);
+        coordinator = NULL;
+    }
+    for (int w = 0; w < worker_count; ++w) {
+        if (workers[w].thread != NULL) {
+            SDL_SemPost(workers[w].start);
+            SDL_WaitThread(workers[w].thread, NULL);
+            workers[w].thread = NULL;
+        }
+        if (workers[w].start != NULL) {
+            SDL_DestroySemaphore(workers[w].start);
+            workers[w].start = NULL;
+        }
+    }
+    worker_count = 0;
+    if (snapshot_lock != NULL) SDL_DestroyMutex(snapshot_lock);
+    if (snapshot_ready != NULL) SDL_DestroySemaphore(snapshot_ready);
+    if (workers_done != NULL) SDL_DestroySemaphore(workers_done);
+    snapshot_lock = NULL;
+    snapshot_ready = NULL;
+    workers_done = NULL;
+    for (int i = 0; i < 3; ++i) {
+        free(slots[i].polyline);
+        slots[i].polyline = NULL;
+    }
+    power_basis_free(&job_basis);
+}
+
+// UI thread: cheap, only copies the control points
+void pipeline_submit(const Point points[]) {
+    SDL_LockMutex(snapshot_lock);
+    memcpy(snapshot, points, sizeof(snapshot));
+    SDL_AtomicSet(&latest_generation, (int)++snapshot_generation);
+    SDL_UnlockMutex(snapshot_lock);
+    SDL_SemPost(snapshot_ready);
+}
+
+// UI thread: the newest finished geometry, NULL until the first job completes
+const Geometry* pipeline_latest(void) {
+    if (SDL_AtomicGet(&handoff) & SLOT_FRESH) {
+        int old = SDL_AtomicSet(&handoff, front);
+        front = old & ~SLOT_FRESH;
+    }
+    return slots[front].generation > 0 ? &slots[front] : NULL;
+}
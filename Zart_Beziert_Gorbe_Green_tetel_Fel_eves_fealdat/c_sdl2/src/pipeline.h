@@ -0,0 +1,20 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+
+// Result of one snapshot. polyline has the tessellate_segments() layout; area and
+// error match calculate_area() for the same points and steps.
+typedef struct Geometry {
+    unsigned generation;
+    Point points[N_POINTS];
+    Point* polyline;
+    int count;
+    double area;
+    double error;
+    double length;
+} Geometry;
+
+bool pipeline_start(int steps);
+void pipeline_stop(void);
+void pipeline_submit(const Point points[]);
+const Geometry* pipeline_latest(void);
@@ -0,0 +1,219 @@
+#include "power_basis.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POWER_BASIS_ARRAYS 12
+#define DOUBLES_PER_LINE (POWER_BASIS_ALIGNMENT / (int)sizeof(double))
+
+static void* aligned_block(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, POWER_BASIS_ALIGNMENT);
+#else
+    return aligned_alloc(POWER_BASIS_ALIGNMENT, size);
+#endif
+}
+
+static void free_aligned_block(void* block) {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    free(block);
+#endif
+}
+
+static double cross(Point a, Point b) {
+    return a.x * b.y - b.x * a.y;
+}
+
+PowerCubic power_cubic(const Point p[4]) {
+    PowerCubic cubic;
+    cubic.a.x = p[3].x - 3.0 * p[2].x + 3.0 * p[1].x - p[0].x;
+    cubic.a.y = p[3].y - 3.0 * p[2].y + 3.0 * p[1].y - p[0].y;
+    cubic.b.x = 3.0 * (p[2].x - 2.0 * p[1].x + p[0].x);
+    cubic.b.y = 3.0 * (p[2].y - 2.0 * p[1].y + p[0].y);
+    cubic.c.x = 3.0 * (p[1].x - p[0].x);
+    cubic.c.y = 3.0 * (p[1].y - p[0].y);
+    cubic.d = p[0];
+    return cubic;
+}
+
+// Every array starts on its own cache line
+static bool reserve(PowerBasis* basis, int count) {
+    if (count <= basis->capacity) {
+        return true;
+    }
+    int capacity = (count + DOUBLES_PER_LINE - 1) / DOUBLES_PER_LINE * DOUBLES_PER_LINE;
+    size_t bytes = (size_t)POWER_BASIS_ARRAYS * capacity * sizeof(double);
+    double* block = aligned_block(bytes);
+    Segment* keys = malloc(capacity * sizeof(Segment));
+    if (block == NULL || keys == NULL) {
+        free_aligned_block(block);
+        free(keys);
+        return false;
+    }
+    free_aligned_block(basis->block);
+    free(basis->keys);
+    basis->block = block;
+    basis->keys = keys;
+    basis->capacity = capacity;
+    double** arrays[POWER_BASIS_ARRAYS] = {
+        &basis->ax, &basis->bx, &basis->cx, &basis->dx, &basis->ay, &basis->by, &basis->cy, &basis->dy,
+        &basis->dax, &basis->dbx, &basis->day, &basis->dby
+    };
+    for (int k = 0; k < POWER_BASIS_ARRAYS; ++k) {
+        *arrays[k] = block + (size_t)k * capacity;
+    }
+    basis->count = 0;   // nothing cached in the new block yet
+    return true;
+}
+
+// Converts the segments whose control points differ from the cached ones; a static
+// curve costs one comparison per segment
+bool power_basis_update(PowerBasis* basis, const Segment segments[], int count) {
+    if (!reserve(basis, count)) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (i < basis->count && memcmp(&basis->keys[i], &segments[i], sizeof(Segment)) == 0) {
+            continue;
+        }
+        basis->keys[i] = segments[i];
+        PowerCubic cubic = power_cubic(segments[i].p);
+        basis->ax[i] = cubic.a.x;
+        basis->bx[i] = cubic.b.x;
+        basis->cx[i] = cubic.c.x;
+        basis->dx[i] = cubic.d.x;
+        basis->ay[i] = cubic.a.y;
+        basis->by[i] = cubic.b.y;
+        basis->cy[i] = cubic.c.y;
+        basis->dy[i] = cubic.d.y;
+        basis->dax[i] = 3.0 * cubic.a.x;
+        basis->dbx[i] = 2.0 * cubic.b.x;
+        basis->day[i] = 3.0 * cubic.a.y;
+        basis->dby[i] = 2.0 * cubic.b.y;
+        ++basis->conversions;
+    }
+    basis->count = count;
+    return true;
+}
+
+void power_basis_free(PowerBasis* basis) {
+    free_aligned_block(basis->block);
+    free(basis->keys);
+    memset(basis, 0, sizeof(*basis));
+}
+
+Point power_basis_eval(const PowerBasis* basis, int segment, double t) {
+    int i = segment;
+    Point p = {
+        ((basis->ax[i] * t + basis->bx[i]) * t + basis->cx[i]) * t + basis->dx[i],
+        ((basis->ay[i] * t + basis->by[i]) * t + basis->cy[i]) * t + basis->dy[i]
+    };
+    return p;
+}
+
+Point power_basis_tangent(const PowerBasis* basis, int segment, double t) {
+    int i = segment;
+    Point d = {
+        (basis->dax[i] * t + basis->dbx[i]) * t + basis->cx[i],
+        (basis->day[i] * t + basis->dby[i]) * t + basis->cy[i]
+    };
+    return d;
+}
+
+// Signed, positive where the curve turns left; 0 where the velocity vanishes
+double power_basis_curvature(const PowerBasis* basis, int segment, double t) {
+    int i = segment;
+    Point d1 = power_basis_tangent(basis, segment, t);
+    Point d2 = { 2.0 * basis->dax[i] * t + basis->dbx[i], 2.0 * basis->day[i] * t + basis->dby[i] };
+    double speed = hypot(d1.x, d1.y);
+    if (speed == 0.0) {
+        return 0.0;
+    }
+    return cross(d1, d2) / (speed * speed * speed);
+}
+
+// Position, both derivatives and curvature in one pass: the powers of t are shared, and
+// the second derivative reuses the derivative coefficients
+static inline CurveSample sample_at(double ax, double bx, double cx, double dx, double dax, double dbx,
+                                    double ay, double by, double cy, double dy, double day, double dby, double t) {
+    CurveSample s;
+    s.position.x = ((ax * t + bx) * t + cx) * t + dx;
+    s.position.y = ((ay * t + by) * t + cy) * t + dy;
+    s.d1.x = (dax * t + dbx) * t + cx;
+    s.d1.y = (day * t + dby) * t + cy;
+    s.d2.x = 2.0 * dax * t + dbx;
+    s.d2.y = 2.0 * day * t + dby;
+    double speed_squared = s.d1.x * s.d1.x + s.d1.y * s.d1.y;
+    s.curvature = speed_squared > 0.0 ? cross(s.d1, s.d2) / (speed_squared * sqrt(speed_squared)) : 0.0;
+    return s;
+}
+
+void power_basis_sample(const PowerBasis* basis, int segment, const double t[], int count, CurveSample out[]) {
+    int i = segment;
+    double ax = basis->ax[i], bx = basis->bx[i], cx = basis->cx[i], dx = basis->dx[i];
+    double ay = basis->ay[i], by = basis->by[i], cy = basis->cy[i], dy = basis->dy[i];
+    double dax = basis->dax[i], dbx = basis->dbx[i], day = basis->day[i], dby = basis->dby[i];
+    for (int k = 0; k < count; ++k) {
+        out[k] = sample_at(ax, bx, cx, dx, dax, dbx, ay, by, cy, dy, day, dby, t[k]);
+    }
+}
+
+// steps + 1 samples per segment at t = j / steps, in the tessellate_segments() layout
+int power_basis_sample_chain(const PowerBasis* basis, int steps, CurveSample out[]) {
+    int written = 0;
+    double inverse_steps = 1.0 / steps;
+    for (int i = 0; i < basis->count; ++i) {
+        double ax = basis->ax[i], bx = basis->bx[i], cx = basis->cx[i], dx = basis->dx[i];
+        double ay = basis->ay[i], by = basis->by[i], cy = basis->cy[i], dy = basis->dy[i];
+        double dax = basis->dax[i], dbx = basis->dbx[i], day = basis->day[i], dby = basis->dby[i];
+        for (int j = 0; j <= steps; ++j) {
+            out[written++] = sample_at(ax, bx, cx, dx, dax, dbx, ay, by, cy, dy, day, dby, j * inverse_steps);
+        }
+    }
+    return written;
+}
+
+// Same layout as tessellate_segments(). The end samples are the cached control points,
+// so neighbouring segments meet exactly where the Bernstein form would put them.
+int power_basis_tessellate(const PowerBasis* basis, int steps, Point out[]) {
+    int written = 0;
+    double inverse_steps = 1.0 / steps;
+    for (int i = 0; i < basis->count; ++i) {
+        double ax = basis->ax[i], bx = basis->bx[i], cx = basis->cx[i], dx = basis->dx[i];
+        double ay = basis->ay[i], by = basis->by[i], cy = basis->cy[i], dy = basis->dy[i];
+        out[written] = basis->keys[i].p[0];
+        for (int j = 1; j < steps; ++j) {
+            double t = j * inverse_steps;
+            out[written + j].x = ((ax * t + bx) * t + cx) * t + dx;
+            out[written + j].y = ((ay * t + by) * t + cy) * t + dy;
+        }
+        out[written + steps] = basis->keys[i].p[3];
+        written += steps + 1;
+    }
+    return written;
+}
+
+// Exact Green area of the chain closed by chords between consecutive segments, in the
+// winding-weighted sense of segment_moments(). With x = sum X_j t^j and y = sum Y_k t^k,
+//   integral of (x y' - y x') dt over [0, 1] = sum over j < k of (X_j Y_k - X_k Y_j) (k - j) / (j + k).
+// Taken about the first point, like segment_moments().
+double power_basis_area(const PowerBasis* basis) {
+    if (basis->count == 0) {
+        return 0.0;
+    }
+    Point origin = basis->keys[0].p[0];
+    double twice = 0.0;
+    for (int i = 0; i < basis->count; ++i) {
+        Point a = { basis->ax[i], basis->ay[i] };
+        Point b = { basis->bx[i], basis->by[i] };
+        Point c = { basis->cx[i], basis->cy[i] };
+        Point d = { basis->dx[i] - origin.x, basis->dy[i] - origin.y };
+        twice += cross(d, c) + cross(d, b) + cross(d, a) + cross(c, b) / 3.0 + cross(c, a) / 2.0 + cross(b, a) / 5.0;
+        Point from = basis->keys[i].p[3];
+        Point to = basis->keys[(i + 1) % basis->count].p[0];
+        twice += cross((Point){ from.x - origin.x, from.y - origin.y }, (Point){ to.x - origin.x, to.y - origin.y });
+    }
+    return fabs(twice) / 2.0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+
+// Cubic segments converted once from the Bernstein form into power basis:
+//   x(t) = ((a.x t + b.x) t + c.x) t + d.x
+//   x'(t) = (da.x t + db.x) t + c.x,  x''(t) = 2 da.x t + db.x   with da = 3a, db = 2b
+// PowerBasis keeps every coefficient of every segment in its own array (structure of
+// arrays), aligned to a cache line, so sampling loops stream through contiguous memory.
+// Segments are reconverted only when their control points change.
+#define POWER_BASIS_ALIGNMENT 64
+
+typedef struct PowerCubic {
+    Point a, b, c, d;
+} PowerCubic;
+
+// Everything the derivative queries need at one parameter
+typedef struct CurveSample {
+    Point position;
+    Point d1;                   // first derivative
+    Point d2;                   // second derivative
+    double curvature;           // signed, positive where the curve turns left
+} CurveSample;
+
+typedef struct PowerBasis {
+    int count;
+    int capacity;
+    Segment* keys;              // control points behind the coefficients
+    double* block;              // one allocation for all coefficient arrays
+    double *ax, *bx, *cx, *dx;
+    double *ay, *by, *cy, *dy;
+    double *dax, *dbx, *day, *dby;
+    long conversions;           // segments converted so far; stays put for a static curve
+} PowerBasis;
+
+PowerCubic power_cubic(const Point p[4]);
+bool power_basis_update(PowerBasis* basis, const Segment segments[], int count);
+void power_basis_free(PowerBasis* basis);
+Point power_basis_eval(const PowerBasis* basis, int segment, double t);
+Point power_basis_tangent(const PowerBasis* basis, int segment, double t);
+double power_basis_curvature(const PowerBasis* basis, int segment, double t);
+int power_basis_tessellate(const PowerBasis* basis, int steps, Point out[]);
+void power_basis_sample(const PowerBasis* basis, int segment, const double t[], int count, CurveSample out[]);
+int power_basis_sample_chain(const PowerBasis* basis, int steps, CurveSample out[]);
+double power_basis_area(const PowerBasis* basis);
+
+static inline Point power_cubic_eval(const PowerCubic* cubic, double t) {
+    Point p = {
+        ((cubic->a.x * t + cubic->b.x) * t + cubic->c.x) * t + cubic->d.x,
+        ((cubic->a.y * t + cubic->b.y) * t + cubic->c.y) * t + cubic->d.y
+    };
+    return p;
+}
@@ -0,0 +1,177 @@
+#include "profile.h"
+
+#ifdef PROFILING
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_ZONES 16
+#define MAX_DEPTH 16
+#define FRAME_HISTORY 120
+#define MAX_TRACE_EVENTS (1 << 18)
+#define OVERLAY_PIXELS_PER_MS 4
+#define OVERLAY_BAR_WIDTH 3
+#define OVERLAY_MARGIN 10
+
+typedef struct TraceEvent {
+    int zone;
+    Uint64 start;
+    Uint64 duration;
+} TraceEvent;
+
+typedef struct FrameStats {
+    double zone_ms[MAX_ZONES];
+    double total_ms;
+    long counters[PROFILE_COUNTER_COUNT];
+} FrameStats;
+
+static const char* counter_names[PROFILE_COUNTER_COUNT] = { "esemeny", "kiertekelt pont", "rajzolas" };
+static const Uint8 zone_colors[MAX_ZONES][3] = {
+    { 230, 60, 60 }, { 60, 170, 60 }, { 60, 90, 230 }, { 230, 160, 30 },
+    { 160, 60, 200 }, { 30, 180, 190 }, { 200, 200, 40 }, { 120, 120, 120 },
+    { 250, 120, 160 }, { 100, 60, 30 }, { 40, 120, 80 }, { 20, 40, 120 },
+    { 180, 100, 60 }, { 120, 180, 250 }, { 90, 30, 90 }, { 0, 0, 0 }
+};
+
+static const char* zone_names[MAX_ZONES];
+static int zone_count = 0;
+static ProfileScope open_spans[MAX_DEPTH];
+static int open_depth = 0;
+static FrameStats current;
+static FrameStats history[FRAME_HISTORY];
+static int history_next = 0;
+static Uint64 frame_start = 0;
+static bool overlay_visible = false;
+// Chrome trace events: a ring buffer, the oldest ones are overwritten
+static TraceEvent trace[MAX_TRACE_EVENTS];
+static long trace_written = 0;
+static Uint64 trace_origin = 0;
+
+static int register_zone(const char* name, int* zone) {
+    if (*zone < 0) {
+        if (zone_count == MAX_ZONES) {
+            return MAX_ZONES - 1;   // overflow zones share the last slot
+        }
+        zone_names[zone_count] = name;
+        *zone = zone_count++;
+    }
+    return *zone;
+}
+
+ProfileScope profile_scope_begin(const char* name, int* zone) {
+    if (trace_origin == 0) {
+        trace_origin = SDL_GetPerformanceCounter();
+    }
+    ProfileScope scope = { register_zone(name, zone), SDL_GetPerformanceCounter() };
+    return scope;
+}
+
+void profile_scope_end(ProfileScope* scope) {
+    Uint64 end = SDL_GetPerformanceCounter();
+    current.zone_ms[scope->zone] += (end - scope->start) * 1000.0 / SDL_GetPerformanceFrequency();
+    TraceEvent* event = &trace[trace_written++ % MAX_TRACE_EVENTS];
+    event->zone = scope->zone;
+    event->start = scope->start;
+    event->duration = end - scope->start;
+}
+
+void profile_begin(const char* name, int* zone) {
+    ProfileScope scope = profile_scope_begin(name, zone);
+    if (open_depth < MAX_DEPTH) {
+        open_spans[open_depth] = scope;
+    }
+    ++open_depth;
+}
+
+void profile_end(void) {
+    if (open_depth == 0) {
+        return;
+    }
+    --open_depth;
+    if (open_depth < MAX_DEPTH) {
+        profile_scope_end(&open_spans[open_depth]);
+    }
+}
+
+void profile_count(ProfileCounter counter, long amount) {
+    current.counters[counter] += amount;
+}
+
+void profile_frame(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (frame_start != 0) {
+        current.total_ms = (now - frame_start) * 1000.0 / SDL_GetPerformanceFrequency();
+        history[history_next] = current;
+        history_next = (history_next + 1) % FRAME_HISTORY;
+    }
+    memset(&current, 0, sizeof(current));
+    frame_start = now;
+}
+
+void profile_toggle_overlay(void) {
+    overlay_visible = !overlay_visible;
+    if (overlay_visible) {
+        printf("\nProfil savok (alulrol felfele):");
+        for (int z = 0; z < zone_count; ++z) {
+            printf(" %s=(%d,%d,%d)", zone_names[z], zone_colors[z][0], zone_colors[z][1], zone_colors[z][2]);
+        }
+        printf("\n");
+    }
+}
+
+// Stacked zone times of the last frames as bars, with a line at 60 fps. The counters of
+// the last finished frame go to the window title since there is no text rendering.
+void profile_draw_overlay(SDL_Window* window, SDL_Renderer* renderer) {
+    if (!overlay_visible) {
+        return;
+    }
+    int base_y = WINDOW_HEIGHT - OVERLAY_MARGIN;
+    for (int f = 0; f < FRAME_HISTORY; ++f) {
+        const FrameStats* frame = &history[(history_next + f) % FRAME_HISTORY];
+        int x = OVERLAY_MARGIN + f * OVERLAY_BAR_WIDTH;
+        int y = base_y;
+        for (int z = 0; z < zone_count; ++z) {
+            int height = (int)(frame->zone_ms[z] * OVERLAY_PIXELS_PER_MS + 0.5);
+            if (height == 0) {
+                continue;
+            }
+            SDL_Rect bar = { x, y - height, OVERLAY_BAR_WIDTH - 1, height };
+            SDL_SetRenderDrawColor(renderer, zone_colors[z][0], zone_colors[z][1], zone_colors[z][2], SDL_ALPHA_OPAQUE);
+            SDL_RenderFillRect(renderer, &bar);
+            y -= height;
+        }
+    }
+    int budget_y = base_y - (int)(1000.0 / 60.0 * OVERLAY_PIXELS_PER_MS);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    SDL_RenderDrawLine(renderer, OVERLAY_MARGIN, budget_y, OVERLAY_MARGIN + FRAME_HISTORY * OVERLAY_BAR_WIDTH, budget_y);
+
+    const FrameStats* last = &history[(history_next + FRAME_HISTORY - 1) % FRAME_HISTORY];
+    char title[256];
+    int length = snprintf(title, sizeof(title), "Keppkocka: %.2f ms", last->total_ms);
+    for (int c = 0; c < PROFILE_COUNTER_COUNT && length < (int)sizeof(title); ++c) {
+        length += snprintf(title + length, sizeof(title) - length, "  %s: %ld", counter_names[c], last->counters[c]);
+    }
+    SDL_SetWindowTitle(window, title);
+}
+
+// Chrome trace format, viewable in chrome://tracing or Perfetto
+bool profile_export(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    double to_us = 1e6 / SDL_GetPerformanceFrequency();
+    long first = trace_written > MAX_TRACE_EVENTS ? trace_written - MAX_TRACE_EVENTS : 0;
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (long i = first; i < trace_written; ++i) {
+        const TraceEvent* event = &trace[i % MAX_TRACE_EVENTS];
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}\n",
+                i == first ? "" : ",", zone_names[event->zone],
+                (event->start - trace_origin) * to_us, event->duration * to_us);
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    printf("Profil nyomvonal mentve: %s (%ld esemeny)\n", path, trace_written - first);
+    return true;
+}
+
+#endif
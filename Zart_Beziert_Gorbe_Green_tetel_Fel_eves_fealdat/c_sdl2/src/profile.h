@@ -0,0 +1,59 @@
+#pragma once
+// Hot-path instrumentation. Everything here compiles to nothing unless the build
+// defines PROFILING (make profile / make linux-profile). Main thread only.
+#include "types.h"
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+typedef enum ProfileCounter {
+    PROFILE_EVENTS,
+    PROFILE_POINTS,
+    PROFILE_DRAW_CALLS,
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+#ifdef PROFILING
+
+typedef struct ProfileScope {
+    int zone;
+    Uint64 start;
+} ProfileScope;
+
+ProfileScope profile_scope_begin(const char* name, int* zone);
+void profile_scope_end(ProfileScope* scope);
+void profile_begin(const char* name, int* zone);
+void profile_end(void);
+void profile_count(ProfileCounter counter, long amount);
+void profile_frame(void);
+void profile_toggle_overlay(void);
+void profile_draw_overlay(SDL_Window* window, SDL_Renderer* renderer);
+bool profile_export(const char* path);
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Times the rest of the enclosing block
+#define PROFILE_SCOPE(name) \
+    static int PROFILE_CONCAT(profile_zone_, __LINE__) = -1; \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__) __attribute__((cleanup(profile_scope_end))) = \
+        profile_scope_begin(name, &PROFILE_CONCAT(profile_zone_, __LINE__))
+// Explicit pairs for spans that do not match a block; they nest
+#define PROFILE_BEGIN(name) do { static int profile_zone_ = -1; profile_begin(name, &profile_zone_); } while (0)
+#define PROFILE_END() profile_end()
+#define PROFILE_COUNT(counter, amount) profile_count(counter, amount)
+#define PROFILE_FRAME() profile_frame()
+#define PROFILE_TOGGLE_OVERLAY() profile_toggle_overlay()
+#define PROFILE_DRAW_OVERLAY(window, renderer) profile_draw_overlay(window, renderer)
+#define PROFILE_EXPORT(path) profile_export(path)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_TOGGLE_OVERLAY() ((void)0)
+#define PROFILE_DRAW_OVERLAY(window, renderer) ((void)0)
+#define PROFILE_EXPORT(path) ((void)0)
+
+#endif
@@ -0,0 +1,392 @@
+#include "query.h"
+#include "bezier.h"
+#include <SDL2/SDL.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define BVH_LEAF_SIZE 4
+#define BVH_MAX_DEPTH 64
+#define MAX_QUERY_THREADS 16
+#define MIN_QUERIES_PER_THREAD 2048
+#define NEWTON_ITERATIONS 8
+
+typedef struct QueryJob {
+    const CurveQuery* query;
+    const Point* q;
+    int begin;
+    int end;
+    int* winding_out;
+    NearestPoint* nearest_out;
+} QueryJob;
+
+static Point piece_point(const MonotonePiece* piece, double u) {
+    Point p = {
+        ((piece->a.x * u + piece->b.x) * u + piece->c.x) * u + piece->d.x,
+        ((piece->a.y * u + piece->b.y) * u + piece->c.y) * u + piece->d.y
+    };
+    return p;
+}
+
+static Point piece_derivative(const MonotonePiece* piece, double u) {
+    Point p = {
+        (3.0 * piece->a.x * u + 2.0 * piece->b.x) * u + piece->c.x,
+        (3.0 * piece->a.y * u + 2.0 * piece->b.y) * u + piece->c.y
+    };
+    return p;
+}
+
+static MonotonePiece make_piece(const Segment* segment, double t0, double t1, int index) {
+    const Point* p = segment->p;
+    MonotonePiece piece;
+    piece.a.x = p[3].x - 3.0 * p[2].x + 3.0 * p[1].x - p[0].x;
+    piece.a.y = p[3].y - 3.0 * p[2].y + 3.0 * p[1].y - p[0].y;
+    piece.b.x = 3.0 * (p[2].x - 2.0 * p[1].x + p[0].x);
+    piece.b.y = 3.0 * (p[2].y - 2.0 * p[1].y + p[0].y);
+    piece.c.x = 3.0 * (p[1].x - p[0].x);
+    piece.c.y = 3.0 * (p[1].y - p[0].y);
+    piece.d = p[0];
+    piece.t0 = t0;
+    piece.t1 = t1;
+    piece.segment = index;
+    // Monotone, so the endpoints bound the piece exactly
+    piece.min.x = fmin(p[0].x, p[3].x);
+    piece.min.y = fmin(p[0].y, p[3].y);
+    piece.max.x = fmax(p[0].x, p[3].x);
+    piece.max.y = fmax(p[0].y, p[3].y);
+    piece.direction = p[3].y > p[0].y ? 1 : (p[3].y < p[0].y ? -1 : 0);
+    return piece;
+}
+
+// Roots of a t^2 + b t + c strictly inside (0, 1), appended to roots[]
+static int add_quadratic_roots(double a, double b, double c, double roots[], int n) {
+    const double margin = 1e-9;
+    if (fabs(a) < 1e-12) {
+        if (fabs(b) > 1e-12) {
+            double t = -c / b;
+            if (t > margin && t < 1.0 - margin) roots[n++] = t;
+        }
+        return n;
+    }
+    double discriminant = b * b - 4.0 * a * c;
+    if (discriminant < 0.0) {
+        return n;
+    }
+    double s = sqrt(discriminant);
+    double q = -0.5 * (b + (b < 0.0 ? -s : s));     // avoids cancellation
+    double t1 = q / a;
+    double t2 = q != 0.0 ? c / q : t1;
+    if (t1 > margin && t1 < 1.0 - margin) roots[n++] = t1;
+    if (t2 > margin && t2 < 1.0 - margin && fabs(t2 - t1) > margin) roots[n++] = t2;
+    return n;
+}
+
+// Splits at the extrema of x(t) and y(t): at most four cuts, five pieces
+static int split_monotone(const Segment* segment, int index, MonotonePiece out[]) {
+    const Point* p = segment->p;
+    double cuts[6];
+    int n = 0;
+    // B'(t)/3 = A t^2 + 2 B t + C with A = -p0 + 3p1 - 3p2 + p3, B = p0 - 2p1 + p2, C = p1 - p0
+    n = add_quadratic_roots(-p[0].x + 3 * p[1].x - 3 * p[2].x + p[3].x, 2 * (p[0].x - 2 * p[1].x + p[2].x), p[1].x - p[0].x, cuts, n);
+    n = add_quadratic_roots(-p[0].y + 3 * p[1].y - 3 * p[2].y + p[3].y, 2 * (p[0].y - 2 * p[1].y + p[2].y), p[1].y - p[0].y, cuts, n);
+    for (int i = 1; i < n; ++i) {
+        double t = cuts[i];
+        int k = i - 1;
+        while (k >= 0 && cuts[k] > t) {
+            cuts[k + 1] = cuts[k];
+            --k;
+        }
+        cuts[k + 1] = t;
+    }
+
+    int pieces = 0;
+    double t0 = 0.0;
+    for (int i = 0; i <= n; ++i) {
+        double t1 = i < n ? cuts[i] : 1.0;
+        if (t1 - t0 < 1e-9) {
+            continue;
+        }
+        Segment part = sub_segment(segment, t0, t1);
+        out[pieces++] = make_piece(&part, t0, t1, index);
+        t0 = t1;
+    }
+    return pieces;
+}
+
+static int compare_center_x(const void* lhs, const void* rhs) {
+    const MonotonePiece* a = lhs;
+    const MonotonePiece* b = rhs;
+    double ca = a->min.x + a->max.x, cb = b->min.x + b->max.x;
+    return (ca > cb) - (ca < cb);
+}
+
+static int compare_center_y(const void* lhs, const void* rhs) {
+    const MonotonePiece* a = lhs;
+    const MonotonePiece* b = rhs;
+    double ca = a->min.y + a->max.y, cb = b->min.y + b->max.y;
+    return (ca > cb) - (ca < cb);
+}
+
+// Fills nodes[index] and, for inner nodes, a freshly allocated pair of children;
+// the split is at the median along the longer side of the box
+static void build_node(CurveQuery* query, int index, int first, int count) {
+    BvhNode* node = &query->nodes[index];
+    node->min = query->pieces[first].min;
+    node->max = query->pieces[first].max;
+    for (int i = first + 1; i < first + count; ++i) {
+        node->min.x = fmin(node->min.x, query->pieces[i].min.x);
+        node->min.y = fmin(node->min.y, query->pieces[i].min.y);
+        node->max.x = fmax(node->max.x, query->pieces[i].max.x);
+        node->max.y = fmax(node->max.y, query->pieces[i].max.y);
+    }
+    if (count <= BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    bool split_x = node->max.x - node->min.x >= node->max.y - node->min.y;
+    qsort(query->pieces + first, count, sizeof(MonotonePiece), split_x ? compare_center_x : compare_center_y);
+    int left = query->node_count;
+    query->node_count += 2;
+    node->first = left;
+    node->count = 0;
+    build_node(query, left, first, count / 2);
+    build_node(query, left + 1, first + count / 2, count - count / 2);
+}
+
+// The closing chords from each segment end to the next segment start are part of the
+// boundary, exactly as in the shoelace sum of calculate_area()
+bool query_build(CurveQuery* query, const Segment segments[], int count) {
+    query->pieces = malloc(6 * (size_t)count * sizeof(MonotonePiece));
+    query->piece_count = 0;
+    query->nodes = NULL;
+    query->node_count = 0;
+    if (query->pieces == NULL || count == 0) {
+        return query->pieces != NULL;
+    }
+    for (int i = 0; i < count; ++i) {
+        query->piece_count += split_monotone(&segments[i], i, query->pieces + query->piece_count);
+        Point from = segments[i].p[3];
+        Point to = segments[(i + 1) % count].p[0];
+        if (from.x != to.x || from.y != to.y) {
+            Segment chord = { {
+                from,
+                { from.x + (to.x - from.x) / 3.0, from.y + (to.y - from.y) / 3.0 },
+                { from.x + (to.x - from.x) * 2.0 / 3.0, from.y + (to.y - from.y) * 2.0 / 3.0 },
+                to
+            } };
+            query->pieces[query->piece_count++] = make_piece(&chord, 0.0, 1.0, -1);
+        }
+    }
+
+    query->nodes = malloc(2 * (size_t)query->piece_count * sizeof(BvhNode));
+    if (query->nodes == NULL) {
+        query_free(query);
+        return false;
+    }
+    query->node_count = 1;
+    build_node(query, 0, 0, query->piece_count);
+    return true;
+}
+
+void query_free(CurveQuery* query) {
+    free(query->pieces);
+    free(query->nodes);
+    query->pieces = NULL;
+    query->nodes = NULL;
+    query->piece_count = 0;
+    query->node_count = 0;
+}
+
+// Ray from q towards +x. A piece whose y range holds q.y and which lies entirely to the
+// right is crossed without solving anything; only pieces straddling q.x need a root.
+static int piece_crossing(const MonotonePiece* piece, Point q) {
+    if (piece->direction == 0 || q.y < piece->min.y || q.y >= piece->max.y || q.x > piece->max.x) {
+        return 0;
+    }
+    if (q.x < piece->min.x) {
+        return piece->direction;
+    }
+    // y is monotone on the piece: safeguarded Newton for y(u) = q.y
+    double lo = 0.0, hi = 1.0;
+    double y0 = piece->d.y;
+    double y1 = piece->a.y + piece->b.y + piece->c.y + piece->d.y;
+    double u = (q.y - y0) / (y1 - y0);
+    for (int i = 0; i < 40; ++i) {
+        double f = piece_point(piece, u).y - q.y;
+        if (fabs(f) < 1e-10) {
+            break;
+        }
+        if ((f > 0.0) == (piece->direction > 0)) {
+            hi = u;
+        } else {
+            lo = u;
+        }
+        double slope = piece_derivative(piece, u).y;
+        double next = slope != 0.0 ? u - f / slope : lo;
+        u = next > lo && next < hi ? next : 0.5 * (lo + hi);
+    }
+    return piece_point(piece, u).x > q.x ? piece->direction : 0;
+}
+
+int query_winding(const CurveQuery* query, Point q) {
+    if (query->node_count == 0) {
+        return 0;
+    }
+    int stack[BVH_MAX_DEPTH * 2];
+    int top = 0;
+    int winding = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BvhNode* node = &query->nodes[stack[--top]];
+        if (q.y < node->min.y || q.y > node->max.y || q.x > node->max.x) {
+            continue;
+        }
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; ++i) {
+                winding += piece_crossing(&query->pieces[i], q);
+            }
+        } else {
+            stack[top++] = node->first;
+            stack[top++] = node->first + 1;
+        }
+    }
+    return winding;
+}
+
+// Nonzero rule, the same one the raster fill uses
+bool query_inside(const CurveQuery* query, Point q) {
+    return query_winding(query, q) != 0;
+}
+
+static double box_distance_squared(const BvhNode* node, Point q) {
+    double dx = fmax(fmax(node->min.x - q.x, 0.0), q.x - node->max.x);
+    double dy = fmax(fmax(node->min.y - q.y, 0.0), q.y - node->max.y);
+    return dx * dx + dy * dy;
+}
+
+// Best of a few samples, refined by Newton on (B(u) - q) . B'(u) = 0
+static double project_on_piece(const MonotonePiece* piece, Point q, double* u_out) {
+    double best_u = 0.0, best = DBL_MAX;
+    for (int i = 0; i <= 4; ++i) {
+        Point p = piece_point(piece, i * 0.25);
+        double d = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+        if (d < best) {
+            best = d;
+            best_u = i * 0.25;
+        }
+    }
+    double u = best_u;
+    for (int i = 0; i < NEWTON_ITERATIONS; ++i) {
+        Point p = piece_point(piece, u);
+        Point d1 = piece_derivative(piece, u);
+        Point d2 = { 6.0 * piece->a.x * u + 2.0 * piece->b.x, 6.0 * piece->a.y * u + 2.0 * piece->b.y };
+        double f = (p.x - q.x) * d1.x + (p.y - q.y) * d1.y;
+        double df = d1.x * d1.x + d1.y * d1.y + (p.x - q.x) * d2.x + (p.y - q.y) * d2.y;
+        if (df <= 0.0) {
+            break;
+        }
+        double next = fmin(fmax(u - f / df, 0.0), 1.0);
+        if (fabs(next - u) < 1e-12) {
+            u = next;
+            break;
+        }
+        u = next;
+    }
+    Point p = piece_point(piece, u);
+    double d = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+    if (d > best) {
+        u = best_u;
+        d = best;
+    }
+    *u_out = u;
+    return d;
+}
+
+// Closing chords are skipped: they are not drawn and nobody can pick them
+NearestPoint query_nearest(const CurveQuery* query, Point q) {
+    NearestPoint result = { -1, 0.0, q, INFINITY };
+    if (query->node_count == 0) {
+        return result;
+    }
+    double best = DBL_MAX;
+    int stack[BVH_MAX_DEPTH * 2];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BvhNode* node = &query->nodes[stack[--top]];
+        if (box_distance_squared(node, q) >= best) {
+            continue;
+        }
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; ++i) {
+                const MonotonePiece* piece = &query->pieces[i];
+                if (piece->segment < 0) {
+                    continue;
+                }
+                double u;
+                double d = project_on_piece(piece, q, &u);
+                if (d < best) {
+                    best = d;
+                    result.segment = piece->segment;
+                    result.t = piece->t0 + (piece->t1 - piece->t0) * u;
+                    result.point = piece_point(piece, u);
+                }
+            }
+        } else {
+            // Nearer child goes on top so it tightens the bound first
+            int left = node->first, right = node->first + 1;
+            double d_left = box_distance_squared(&query->nodes[left], q);
+            double d_right = box_distance_squared(&query->nodes[right], q);
+            stack[top++] = d_left < d_right ? right : left;
+            stack[top++] = d_left < d_right ? left : right;
+        }
+    }
+    result.distance = sqrt(best);
+    return result;
+}
+
+static int run_job(void* data) {
+    QueryJob* job = data;
+    for (int i = job->begin; i < job->end; ++i) {
+        if (job->winding_out != NULL) {
+            job->winding_out[i] = query_winding(job->query, job->q[i]);
+        } else {
+            job->nearest_out[i] = query_nearest(job->query, job->q[i]);
+        }
+    }
+    return 0;
+}
+
+// Splits the batch into contiguous ranges on SDL threads; the query itself is read-only.
+// Small batches, or a failed thread start, run on the calling thread.
+static void run_batch(const CurveQuery* query, const Point q[], int count, int winding_out[], NearestPoint nearest_out[]) {
+    int threads = SDL_GetCPUCount();
+    if (threads > MAX_QUERY_THREADS) threads = MAX_QUERY_THREADS;
+    if (threads > count / MIN_QUERIES_PER_THREAD) threads = count / MIN_QUERIES_PER_THREAD;
+    if (threads < 1) threads = 1;
+
+    QueryJob jobs[MAX_QUERY_THREADS];
+    SDL_Thread* handles[MAX_QUERY_THREADS];
+    for (int i = 0; i < threads; ++i) {
+        jobs[i] = (QueryJob){ query, q, (int)((long)count * i / threads), (int)((long)count * (i + 1) / threads),
+                              winding_out, nearest_out };
+        handles[i] = i > 0 ? SDL_CreateThread(run_job, "query", &jobs[i]) : NULL;
+    }
+    run_job(&jobs[0]);
+    for (int i = 1; i < threads; ++i) {
+        if (handles[i] != NULL) {
+            SDL_WaitThread(handles[i], NULL);
+        } else {
+            run_job(&jobs[i]);
+        }
+    }
+}
+
+void query_winding_batch(const CurveQuery* query, const Point q[], int count, int winding_out[]) {
+    run_batch(query, q, count, winding_out, NULL);
+}
+
+void query_nearest_batch(const CurveQuery* query, const Point q[], int count, NearestPoint out[]) {
+    run_batch(query, q, count, NULL, out);
+}
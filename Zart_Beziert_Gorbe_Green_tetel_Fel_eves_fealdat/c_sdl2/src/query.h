@@ -0,0 +1,41 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+
+// Piece of a segment (or of a closing chord) that is monotone in both x and y,
+// stored in power basis: x(u) = ((a.x u + b.x) u + c.x) u + d.x on u in [0, 1]
+typedef struct MonotonePiece {
+    Point min, max;
+    Point a, b, c, d;
+    double t0, t1;      // parameter range on the source segment
+    int segment;        // source segment, -1 for a closing chord
+    int direction;      // +1 when y grows along the piece, -1 when it falls, 0 if flat
+} MonotonePiece;
+
+typedef struct BvhNode {
+    Point min, max;
+    int first;          // leaf: first piece, inner node: left child (right child follows it)
+    int count;          // pieces in a leaf, 0 for inner nodes
+} BvhNode;
+
+typedef struct CurveQuery {
+    MonotonePiece* pieces;
+    int piece_count;
+    BvhNode* nodes;
+    int node_count;
+} CurveQuery;
+
+typedef struct NearestPoint {
+    int segment;
+    double t;
+    Point point;
+    double distance;
+} NearestPoint;
+
+bool query_build(CurveQuery* query, const Segment segments[], int count);
+void query_free(CurveQuery* query);
+int query_winding(const CurveQuery* query, Point q);
+bool query_inside(const CurveQuery* query, Point q);
+NearestPoint query_nearest(const CurveQuery* query, Point q);
+void query_winding_batch(const CurveQuery* query, const Point q[], int count, int winding_out[]);
+void query_nearest_batch(const CurveQuery* query, const Point q[], int count, NearestPoint out[]);
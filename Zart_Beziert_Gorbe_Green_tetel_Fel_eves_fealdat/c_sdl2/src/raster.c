@@ -0,0 +1,185 @@
+#include "raster.h"
+#include "arena.h"
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct Edge {
+    double x;       // x at the current scanline center
+    double dxdy;
+    int y_end;      // first scanline no longer crossed
+    int winding;    // +1 downwards, -1 upwards
+    int next;       // next edge starting on the same scanline
+} Edge;
+
+bool raster_init(Raster* raster, int width, int height) {
+    raster->pixels = malloc((size_t)width * height * sizeof(uint32_t));
+    raster->width = width;
+    raster->height = height;
+    return raster->pixels != NULL;
+}
+
+void raster_free(Raster* raster) {
+    free(raster->pixels);
+    raster->pixels = NULL;
+}
+
+void raster_clear(Raster* raster, uint32_t color) {
+    long n = (long)raster->width * raster->height;
+    for (long i = 0; i < n; ++i) {
+        raster->pixels[i] = color;
+    }
+}
+
+// Vertices come from either storage; edges are set up in double either way
+static Point vertex_at(const Point polygon[], const PointF polygon_f[], int i) {
+    if (polygon != NULL) {
+        return polygon[i];
+    }
+    Point p = { polygon_f[i].x, polygon_f[i].y };
+    return p;
+}
+
+// Scanline fill with an active edge table. Pixel (x, y) is inside when its center
+// (x + 0.5, y + 0.5) has nonzero winding. Returns the number of inside pixels,
+// counted over the whole polygon even where it is clipped by the buffer.
+// winding_area (optional) receives the pixel sum of the winding numbers, which is
+// what the shoelace formula in calculate_area() measures on overlapping loops.
+static long fill_nonzero(Raster* raster, const Point polygon[], const PointF polygon_f[], int count,
+                         uint32_t color, long* winding_area) {
+    if (winding_area != NULL) {
+        *winding_area = 0;
+    }
+    if (count < 3) {
+        return 0;
+    }
+
+    double min_y = vertex_at(polygon, polygon_f, 0).y, max_y = min_y;
+    for (int i = 1; i < count; ++i) {
+        double y = vertex_at(polygon, polygon_f, i).y;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+    int y_first = (int)ceil(min_y - 0.5);
+    int y_last = (int)ceil(max_y - 0.5);    // exclusive
+    int rows = y_last - y_first;
+    if (rows <= 0) {
+        return 0;
+    }
+
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Edge* edges = arena_alloc(scratch, count * sizeof(Edge));
+    int* buckets = arena_alloc(scratch, rows * sizeof(int));
+    int* active = arena_alloc(scratch, count * sizeof(int));
+    if (edges == NULL || buckets == NULL || active == NULL) {
+        arena_release(scratch, mark);
+        return 0;
+    }
+    for (int r = 0; r < rows; ++r) {
+        buckets[r] = -1;
+    }
+
+    // Edge table: every non-horizontal edge is bucketed by its first scanline
+    int n_edges = 0;
+    for (int i = 0; i < count; ++i) {
+        Point a = vertex_at(polygon, polygon_f, i);
+        Point b = vertex_at(polygon, polygon_f, (i + 1) % count);
+        int winding = 1;
+        if (a.y > b.y) {
+            Point tmp = a;
+            a = b;
+            b = tmp;
+            winding = -1;
+        }
+        int y_start = (int)ceil(a.y - 0.5);
+        int y_end = (int)ceil(b.y - 0.5);
+        if (y_start >= y_end) {
+            continue;
+        }
+        Edge* e = &edges[n_edges];
+        e->dxdy = (b.x - a.x) / (b.y - a.y);
+        e->x = a.x + (y_start + 0.5 - a.y) * e->dxdy;
+        e->y_end = y_end;
+        e->winding = winding;
+        e->next = buckets[y_start - y_first];
+        buckets[y_start - y_first] = n_edges;
+        ++n_edges;
+    }
+
+    long filled = 0;
+    long signed_area = 0;
+    int n_active = 0;
+    for (int y = y_first; y < y_last; ++y) {
+        // Drop finished edges, add the ones starting here
+        int kept = 0;
+        for (int k = 0; k < n_active; ++k) {
+            if (edges[active[k]].y_end > y) {
+                active[kept++] = active[k];
+            }
+        }
+        n_active = kept;
+        for (int e = buckets[y - y_first]; e != -1; e = edges[e].next) {
+            active[n_active++] = e;
+        }
+
+        // Insertion sort by x; the order barely changes between scanlines
+        for (int k = 1; k < n_active; ++k) {
+            int e = active[k];
+            int m = k - 1;
+            while (m >= 0 && edges[active[m]].x > edges[e].x) {
+                active[m + 1] = active[m];
+                --m;
+            }
+            active[m + 1] = e;
+        }
+
+        bool row_visible = y >= 0 && y < raster->height;
+        uint32_t* row = row_visible ? raster->pixels + (long)y * raster->width : NULL;
+
+        // A span opens when the winding leaves zero and closes when it returns
+        int winding = 0;
+        double span_start = 0.0;
+        for (int k = 0; k < n_active; ++k) {
+            const Edge* e = &edges[active[k]];
+            if (winding != 0) {
+                int covered = (int)ceil(e->x - 0.5) - (int)ceil(edges[active[k - 1]].x - 0.5);
+                signed_area += (long)winding * covered;
+            } else {
+                span_start = e->x;
+            }
+            winding += e->winding;
+            if (winding == 0) {
+                int x0 = (int)ceil(span_start - 0.5);
+                int x1 = (int)ceil(e->x - 0.5);
+                if (x1 > x0) {
+                    filled += x1 - x0;
+                    if (row_visible) {
+                        if (x0 < 0) x0 = 0;
+                        if (x1 > raster->width) x1 = raster->width;
+                        for (int x = x0; x < x1; ++x) {
+                            row[x] = color;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < n_active; ++k) {
+            edges[active[k]].x += edges[active[k]].dxdy;
+        }
+    }
+
+    arena_release(scratch, mark);
+    if (winding_area != NULL) {
+        *winding_area = signed_area;
+    }
+    return filled;
+}
+
+long fill_polygon_nonzero(Raster* raster, const Point polygon[], int count, uint32_t color, long* winding_area) {
+    return fill_nonzero(raster, polygon, NULL, count, color, winding_area);
+}
+
+long fill_polygon_nonzero_f(Raster* raster, const PointF polygon[], int count, uint32_t color, long* winding_area) {
+    return fill_nonzero(raster, NULL, polygon, count, color, winding_area);
+}
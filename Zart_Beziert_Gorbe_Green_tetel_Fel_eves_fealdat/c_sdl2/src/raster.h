@@ -0,0 +1,16 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct Raster {
+    uint32_t* pixels;   // ARGB8888, row-major, pitch = width * 4
+    int width;
+    int height;
+} Raster;
+
+bool raster_init(Raster* raster, int width, int height);
+void raster_free(Raster* raster);
+void raster_clear(Raster* raster, uint32_t color);
+long fill_polygon_nonzero(Raster* raster, const Point polygon[], int count, uint32_t color, long* winding_area);
+long fill_polygon_nonzero_f(Raster* raster, const PointF polygon[], int count, uint32_t color, long* winding_area);
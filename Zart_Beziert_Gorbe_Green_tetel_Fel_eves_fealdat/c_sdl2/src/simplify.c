@@ -0,0 +1,402 @@
+#include "simplify.h"
+#include "arena.h"
+#include "bezier.h"
+#include "bezier_degree.h"
+#include "stream.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REPARAMETERIZE_STEPS 4
+#define CORNER_COS 0.8              // turning by more than ~37 degrees starts a new run
+#define SAMPLES_PER_SEGMENT 8
+#define REDUCE_SAMPLES 64
+
+typedef struct FitOutput {
+    Point* points;
+    int count;
+    int capacity;
+    double max_error;
+} FitOutput;
+
+static Point add(Point a, Point b) {
+    Point p = { a.x + b.x, a.y + b.y };
+    return p;
+}
+
+static Point sub(Point a, Point b) {
+    Point p = { a.x - b.x, a.y - b.y };
+    return p;
+}
+
+static Point scale(Point a, double s) {
+    Point p = { a.x * s, a.y * s };
+    return p;
+}
+
+static double dot(Point a, Point b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+static Point normalize(Point a) {
+    double length = sqrt(dot(a, a));
+    return length > 0.0 ? scale(a, 1.0 / length) : a;
+}
+
+static bool emit(FitOutput* out, const Point p[4], double error) {
+    if (out->count == out->capacity) {
+        return false;
+    }
+    for (int k = 0; k < 3; ++k) {
+        out->points[3 * out->count + k] = p[k];
+    }
+    ++out->count;
+    if (error > out->max_error) {
+        out->max_error = error;
+    }
+    return true;
+}
+
+// Returns the total chord length; when it is 0 the samples coincide and u is left unscaled
+static double chord_parameters(const Point d[], int n, double u[]) {
+    u[0] = 0.0;
+    for (int i = 1; i < n; ++i) {
+        Point step = sub(d[i], d[i - 1]);
+        u[i] = u[i - 1] + sqrt(dot(step, step));
+    }
+    double length = u[n - 1];
+    if (length == 0.0) {
+        return 0.0;
+    }
+    for (int i = 1; i < n; ++i) {
+        u[i] /= length;
+    }
+    return length;
+}
+
+// Least squares for the two tangent lengths with the end points and directions fixed
+static void fit_segment(const Point d[], const double u[], int n, Point t1, Point t2, Point p[4]) {
+    double c00 = 0.0, c01 = 0.0, c11 = 0.0, x0 = 0.0, x1 = 0.0;
+    Point first = d[0], last = d[n - 1];
+    for (int i = 0; i < n; ++i) {
+        double t = u[i], s = 1.0 - t;
+        double b0 = s * s * s, b1 = 3 * s * s * t, b2 = 3 * s * t * t, b3 = t * t * t;
+        Point a1 = scale(t1, b1), a2 = scale(t2, b2);
+        c00 += dot(a1, a1);
+        c01 += dot(a1, a2);
+        c11 += dot(a2, a2);
+        Point rest = sub(d[i], add(scale(first, b0 + b1), scale(last, b2 + b3)));
+        x0 += dot(a1, rest);
+        x1 += dot(a2, rest);
+    }
+    double det = c00 * c11 - c01 * c01;
+    double alpha1 = det != 0.0 ? (x0 * c11 - x1 * c01) / det : 0.0;
+    double alpha2 = det != 0.0 ? (c00 * x1 - c01 * x0) / det : 0.0;
+    Point chord = sub(last, first);
+    double chord_length = sqrt(dot(chord, chord));
+    // Negative or vanishing lengths mean the fit broke down; fall back to the chord thirds
+    if (alpha1 < 1e-6 * chord_length || alpha2 < 1e-6 * chord_length) {
+        alpha1 = alpha2 = chord_length / 3.0;
+    }
+    p[0] = first;
+    p[1] = add(first, scale(t1, alpha1));
+    p[2] = add(last, scale(t2, alpha2));
+    p[3] = last;
+}
+
+// Largest squared distance of an inner sample from its point on the fit
+static double fit_error(const Point d[], const double u[], int n, const Point p[4], int* split) {
+    double worst = 0.0;
+    *split = n / 2;
+    for (int i = 1; i < n - 1; ++i) {
+        Point diff = sub(bezier(p[0], p[1], p[2], p[3], u[i]), d[i]);
+        double error = dot(diff, diff);
+        if (error > worst) {
+            worst = error;
+            *split = i;
+        }
+    }
+    return worst;
+}
+
+// One Newton step towards the parameter of the point on the fit closest to target
+static double newton_parameter(const Point p[4], Point target, double u) {
+    Point q1[3], q2[2];
+    for (int k = 0; k < 3; ++k) {
+        q1[k] = scale(sub(p[k + 1], p[k]), 3.0);
+    }
+    for (int k = 0; k < 2; ++k) {
+        q2[k] = scale(sub(q1[k + 1], q1[k]), 2.0);
+    }
+    double s = 1.0 - u;
+    Point diff = sub(bezier(p[0], p[1], p[2], p[3], u), target);
+    Point d1 = add(add(scale(q1[0], s * s), scale(q1[1], 2 * s * u)), scale(q1[2], u * u));
+    Point d2 = add(scale(q2[0], s), scale(q2[1], u));
+    double denominator = dot(d1, d1) + dot(diff, d2);
+    if (denominator == 0.0) {
+        return u;
+    }
+    double next = u - dot(diff, d1) / denominator;
+    return next < 0.0 ? 0.0 : next > 1.0 ? 1.0 : next;
+}
+
+// Schneider's fit of the run d[0 .. n-1]; t1 leaves the first point and t2 leaves the last
+// one backwards. Runs that stay off by more than twice the tolerance after
+// reparameterization are split at their worst sample.
+static bool fit_run(Arena* scratch, const Point d[], int n, Point t1, Point t2, double tolerance, FitOutput* out) {
+    Point p[4];
+    if (n == 2) {
+        Point chord = sub(d[1], d[0]);
+        double third = sqrt(dot(chord, chord)) / 3.0;
+        p[0] = d[0];
+        p[1] = add(d[0], scale(t1, third));
+        p[2] = add(d[1], scale(t2, third));
+        p[3] = d[1];
+        return emit(out, p, 0.0);
+    }
+
+    size_t mark = arena_mark(scratch);
+    double* u = arena_alloc(scratch, n * sizeof(double));
+    if (u == NULL) {
+        return false;
+    }
+    if (chord_parameters(d, n, u) == 0.0) {
+        // Every sample is the same point: a segment collapsed onto it fits exactly
+        arena_release(scratch, mark);
+        p[0] = p[1] = p[2] = p[3] = d[0];
+        return emit(out, p, 0.0);
+    }
+    fit_segment(d, u, n, t1, t2, p);
+    int split;
+    double tolerance2 = tolerance * tolerance;
+    double error = fit_error(d, u, n, p, &split);
+    for (int k = 0; k < REPARAMETERIZE_STEPS && error >= tolerance2 && error < 4.0 * tolerance2; ++k) {
+        for (int i = 1; i < n - 1; ++i) {
+            u[i] = newton_parameter(p, d[i], u[i]);
+        }
+        fit_segment(d, u, n, t1, t2, p);
+        error = fit_error(d, u, n, p, &split);
+    }
+    arena_release(scratch, mark);
+    if (error < tolerance2) {
+        return emit(out, p, sqrt(error));
+    }
+
+    Point center = normalize(sub(d[split - 1], d[split + 1]));
+    if (dot(center, center) == 0.0) {
+        center = normalize(sub(d[split - 1], d[split]));
+    }
+    return fit_run(scratch, d, split + 1, t1, center, tolerance, out) &&
+           fit_run(scratch, d + split, n - split, scale(center, -1.0), t2, tolerance, out);
+}
+
+// Fits the fewest cubics it can find that stay within tolerance of every polyline vertex.
+// Sharp turns become segment joints with independent tangents; everywhere else the fit is
+// tangent continuous. Returns the segment count, or -1 when max_segments is too small.
+int fit_closed_polyline(const Point polyline[], int count, double tolerance, Point out[], int max_segments,
+                        double* max_error) {
+    *max_error = 0.0;
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    Point* d = arena_alloc(scratch, (count + 1) * sizeof(Point));
+    bool* corner = arena_alloc(scratch, (count + 1) * sizeof(bool));
+    if (d == NULL || corner == NULL) {
+        arena_release(scratch, mark);
+        return -1;
+    }
+
+    // Repeated vertices would give zero-length chords
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        if (n == 0 || polyline[i].x != d[n - 1].x || polyline[i].y != d[n - 1].y) {
+            d[n++] = polyline[i];
+        }
+    }
+    while (n > 1 && d[n - 1].x == d[0].x && d[n - 1].y == d[0].y) {
+        --n;
+    }
+    if (n < 3) {
+        arena_release(scratch, mark);
+        return 0;
+    }
+
+    // Start at a corner when there is one, so that no run has to bend around it
+    int start = -1;
+    for (int i = 0; i < n; ++i) {
+        Point in = normalize(sub(d[i], d[(i + n - 1) % n]));
+        Point on = normalize(sub(d[(i + 1) % n], d[i]));
+        corner[i] = dot(in, on) < CORNER_COS;
+        if (corner[i] && start < 0) {
+            start = i;
+        }
+    }
+    Point* run = arena_alloc(scratch, (n + 1) * sizeof(Point));
+    bool* run_corner = arena_alloc(scratch, (n + 1) * sizeof(bool));
+    if (run == NULL || run_corner == NULL) {
+        arena_release(scratch, mark);
+        return -1;
+    }
+    int offset = start >= 0 ? start : 0;
+    for (int i = 0; i <= n; ++i) {
+        run[i] = d[(offset + i) % n];
+        run_corner[i] = corner[(offset + i) % n];
+    }
+
+    FitOutput fit = { out, 0, max_segments, 0.0 };
+    bool ok = true;
+    if (start < 0) {
+        Point tangent = normalize(sub(run[1], run[n - 1]));
+        ok = fit_run(scratch, run, n + 1, tangent, scale(tangent, -1.0), tolerance, &fit);
+    } else {
+        int first = 0;
+        for (int i = 1; i <= n && ok; ++i) {
+            if (i == n || run_corner[i]) {
+                Point t1 = normalize(sub(run[first + 1], run[first]));
+                Point t2 = normalize(sub(run[i - 1], run[i]));
+                ok = fit_run(scratch, run + first, i - first + 1, t1, t2, tolerance, &fit);
+                first = i;
+            }
+        }
+    }
+    arena_release(scratch, mark);
+    *max_error = fit.max_error;
+    return ok ? fit.count : -1;
+}
+
+// Approximates a Bezier curve of any degree with a chain of cubics. The end points and end
+// tangents are kept; the tolerance is checked at REDUCE_SAMPLES points of the original.
+int reduce_degree(const Point control[], int degree, double tolerance, Point out[], int max_segments,
+                  double* max_error) {
+    *max_error = 0.0;
+    if (degree <= 3) {
+        // Exact degree elevation: a lower degree curve already is a cubic
+        Point p[4];
+        if (degree == 3) {
+            for (int k = 0; k < 4; ++k) p[k] = control[k];
+        } else if (degree == 2) {
+            p[0] = control[0];
+            p[1] = add(scale(control[0], 1.0 / 3.0), scale(control[1], 2.0 / 3.0));
+            p[2] = add(scale(control[1], 2.0 / 3.0), scale(control[2], 1.0 / 3.0));
+            p[3] = control[2];
+        } else {
+            p[0] = control[0];
+            p[1] = add(scale(control[0], 2.0 / 3.0), scale(control[degree], 1.0 / 3.0));
+            p[2] = add(scale(control[0], 1.0 / 3.0), scale(control[degree], 2.0 / 3.0));
+            p[3] = control[degree];
+        }
+        if (max_segments < 1) {
+            return -1;
+        }
+        for (int k = 0; k < 4; ++k) out[k] = p[k];
+        return 1;
+    }
+
+    Point samples[REDUCE_SAMPLES + 1];
+    double t[REDUCE_SAMPLES + 1];
+    for (int i = 0; i <= REDUCE_SAMPLES; ++i) {
+        t[i] = (double)i / REDUCE_SAMPLES;
+    }
+    bezier_eval_batch(control, degree, t, REDUCE_SAMPLES + 1, samples);
+
+    // Coincident end control points leave the tangent to the samples
+    Point t1 = normalize(sub(control[1], control[0]));
+    Point t2 = normalize(sub(control[degree - 1], control[degree]));
+    if (dot(t1, t1) == 0.0) t1 = normalize(sub(samples[1], samples[0]));
+    if (dot(t2, t2) == 0.0) t2 = normalize(sub(samples[REDUCE_SAMPLES - 1], samples[REDUCE_SAMPLES]));
+
+    FitOutput fit = { out, 0, max_segments, 0.0 };
+    if (!fit_run(scratch_arena(), samples, REDUCE_SAMPLES + 1, t1, t2, tolerance, &fit)) {
+        return -1;
+    }
+    out[3 * fit.count] = control[degree];
+    *max_error = fit.max_error;
+    return fit.count;
+}
+
+// --simplify: refits every curve of a .bzc file from a dense sampling of it. A curve is
+// copied unchanged when the fit would not have fewer segments.
+int simplify_file(const char* in_path, const char* out_path, double tolerance) {
+    CurveFile file;
+    if (!curve_file_open(&file, in_path)) {
+        printf("Hiba: %s nem olvashato .bzc fajl\n", in_path);
+        return 1;
+    }
+    FILE* out = fopen(out_path, "wb");
+    bool ok = out != NULL && write_curve_header(out, file.curve_count);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t curves = 0, segments_in = 0, segments_out = 0;
+    double area_in = 0.0, area_out = 0.0, worst_error = 0.0, worst_area_change = 0.0;
+    Arena* scratch = scratch_arena();
+    uint32_t count;
+    const Point* points;
+    while (ok && (points = curve_file_next(&file, &count)) != NULL) {
+        arena_reset(scratch);
+        int samples = count * SAMPLES_PER_SEGMENT;
+        Point* polyline = arena_alloc(scratch, samples * sizeof(Point));
+        Point* fitted = arena_alloc(scratch, 3 * (size_t)samples * sizeof(Point));
+        if (polyline == NULL || fitted == NULL) {
+            ok = false;
+            break;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            const Point* p = &points[3 * i];
+            Point p3 = points[(3 * i + 3) % (3 * count)];
+            for (int k = 0; k < SAMPLES_PER_SEGMENT; ++k) {
+                polyline[i * SAMPLES_PER_SEGMENT + k] = bezier(p[0], p[1], p[2], p3, (double)k / SAMPLES_PER_SEGMENT);
+            }
+        }
+        double error;
+        int fitted_count = fit_closed_polyline(polyline, samples, tolerance, fitted, samples, &error);
+        const Point* kept = points;
+        uint32_t kept_count = count;
+        if (fitted_count > 0 && (uint32_t)fitted_count < count) {
+            kept = fitted;
+            kept_count = fitted_count;
+            if (error > worst_error) {
+                worst_error = error;
+            }
+        }
+        ok = write_curve_record(out, kept, kept_count);
+
+        double before = closed_curve_area(points, count);
+        double after = closed_curve_area(kept, kept_count);
+        if (before > 0.0 && fabs(after - before) / before > worst_area_change) {
+            worst_area_change = fabs(after - before) / before;
+        }
+        area_in += before;
+        area_out += after;
+        segments_in += count;
+        segments_out += kept_count;
+        ++curves;
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    // The header already promised file.curve_count records, so a short read leaves an
+    // output that --stream would reject; it is removed instead
+    bool complete = curves == file.curve_count && file.cursor == file.size;
+    uint64_t cursor = file.cursor;
+    curve_file_close(&file);
+    if (out != NULL && fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("Hiba: %s nem irhato\n", out_path);
+        return 1;
+    }
+    if (!complete) {
+        printf("Hiba: %s csonka vagy serult (%llu. bajtnal), %s nem keszult el\n", in_path,
+               (unsigned long long)cursor, out_path);
+        remove(out_path);
+        return 1;
+    }
+
+    printf("Gorbek: %llu    Szegmensek: %llu -> %llu (%.1f%%)    Tolerancia: %g\n", (unsigned long long)curves,
+           (unsigned long long)segments_in, (unsigned long long)segments_out,
+           segments_in > 0 ? 100.0 * segments_out / segments_in : 0.0, tolerance);
+    printf("Max elteres: %.4f    Terulet: %.4f -> %.4f (relativ %.2e, gorbenkent max %.2e)\n", worst_error,
+           area_in, area_out, area_in > 0.0 ? fabs(area_out - area_in) / area_in : 0.0, worst_area_change);
+    printf("Ido: %.3f s\n", seconds);
+    return 0;
+}
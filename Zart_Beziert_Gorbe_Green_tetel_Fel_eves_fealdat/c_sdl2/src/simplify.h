@@ -0,0 +1,10 @@
+#pragma once
+#include "types.h"
+
+// Fitted curves use the .bzc record layout: segment i is out[3i .. 3i + 3]. A closed fit
+// wraps around to out[0]; an open one (reduce_degree) ends with an extra point out[3n].
+int fit_closed_polyline(const Point polyline[], int count, double tolerance, Point out[], int max_segments,
+                        double* max_error);
+int reduce_degree(const Point control[], int degree, double tolerance, Point out[], int max_segments,
+                  double* max_error);
+int simplify_file(const char* in_path, const char* out_path, double tolerance);
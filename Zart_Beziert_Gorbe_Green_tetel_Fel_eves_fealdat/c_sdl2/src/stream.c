@@ -0,0 +1,436 @@
+#include "stream.h"
+#include "arena.h"
+#include "power_basis.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BZC_HEADER_SIZE 16
+#define BZC_RECORD_HEADER_SIZE 8
+#define LENGTH_TOLERANCE 1e-9
+#define LENGTH_MAX_DEPTH 12
+#define CSV_LINE_LENGTH 256
+
+static uint64_t map_granularity(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void unmap_window(CurveFile* file) {
+    if (file->window == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(file->window);
+#else
+    munmap(file->window, file->window_length);
+#endif
+    file->window = NULL;
+    file->window_length = 0;
+}
+
+// Makes [offset, offset + length) addressable; the view starts at the granularity boundary
+// below offset and is only replaced when the range runs past it
+static const unsigned char* map_range(CurveFile* file, uint64_t offset, uint64_t length) {
+    if (offset + length > file->size) {
+        return NULL;
+    }
+    if (file->window != NULL && offset >= file->window_offset &&
+        offset + length <= file->window_offset + file->window_length) {
+        return file->window + (offset - file->window_offset);
+    }
+    unmap_window(file);
+    uint64_t start = offset - offset % map_granularity();
+    uint64_t span = offset + length - start;
+    if (span < BZC_WINDOW_SIZE) {
+        span = BZC_WINDOW_SIZE;
+    }
+    if (start + span > file->size) {
+        span = file->size - start;
+    }
+#ifdef _WIN32
+    file->window = MapViewOfFile(file->mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)span);
+#else
+    void* view = mmap(NULL, span, PROT_READ, MAP_PRIVATE, file->fd, (off_t)start);
+    file->window = view == MAP_FAILED ? NULL : view;
+    if (file->window != NULL) {
+        madvise(file->window, span, MADV_SEQUENTIAL);
+    }
+#endif
+    if (file->window == NULL) {
+        return NULL;
+    }
+    file->window_offset = start;
+    file->window_length = span;
+    if (span > file->peak_window) {
+        file->peak_window = span;
+    }
+    return file->window + (offset - start);
+}
+
+bool curve_file_open(CurveFile* file, const char* path) {
+    memset(file, 0, sizeof(*file));
+#ifndef _WIN32
+    file->fd = -1;
+#endif
+#ifdef _WIN32
+    file->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file->file == INVALID_HANDLE_VALUE) {
+        file->file = NULL;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file->file, &size);
+    file->size = (uint64_t)size.QuadPart;
+    file->mapping = file->size > 0 ? CreateFileMappingA(file->file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    if (file->mapping == NULL) {
+        curve_file_close(file);
+        return false;
+    }
+#else
+    file->fd = open(path, O_RDONLY);
+    if (file->fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file->fd, &info) != 0) {
+        curve_file_close(file);
+        return false;
+    }
+    file->size = (uint64_t)info.st_size;
+#endif
+    const unsigned char* header = map_range(file, 0, BZC_HEADER_SIZE);
+    uint32_t version = 0;
+    if (header != NULL) {
+        memcpy(&version, header + 4, sizeof(version));
+        memcpy(&file->curve_count, header + 8, sizeof(file->curve_count));
+    }
+    if (header == NULL || memcmp(header, BZC_MAGIC, 4) != 0 || version != BZC_VERSION) {
+        curve_file_close(file);
+        return false;
+    }
+    file->cursor = BZC_HEADER_SIZE;
+    return true;
+}
+
+void curve_file_close(CurveFile* file) {
+    unmap_window(file);
+#ifdef _WIN32
+    if (file->mapping != NULL) CloseHandle(file->mapping);
+    if (file->file != NULL) CloseHandle(file->file);
+    file->mapping = NULL;
+    file->file = NULL;
+#else
+    if (file->fd >= 0) close(file->fd);
+    file->fd = -1;
+#endif
+}
+
+// Returns the points of the next curve straight from the mapping, or NULL at the end of
+// the file or on a truncated record. The pointer stays valid until the next call.
+const Point* curve_file_next(CurveFile* file, uint32_t* segment_count) {
+    const unsigned char* record = map_range(file, file->cursor, BZC_RECORD_HEADER_SIZE);
+    if (record == NULL) {
+        return NULL;
+    }
+    uint32_t count;
+    memcpy(&count, record, sizeof(count));
+    uint64_t bytes = 3ull * count * sizeof(Point);
+    const unsigned char* points = map_range(file, file->cursor + BZC_RECORD_HEADER_SIZE, bytes);
+    if (points == NULL || count == 0) {
+        return NULL;
+    }
+    file->cursor += BZC_RECORD_HEADER_SIZE + bytes;
+    *segment_count = count;
+    return (const Point*)points;
+}
+
+static double cross(Point a, Point b) {
+    return a.x * b.y - b.x * a.y;
+}
+
+// Green's theorem in closed form for each cubic: 1/2 ∮ x dy - y dx
+double closed_curve_area(const Point points[], uint32_t segment_count) {
+    double area = 0.0;
+    uint64_t n = 3ull * segment_count;
+    for (uint64_t i = 0; i < n; i += 3) {
+        Point p0 = points[i], p1 = points[i + 1], p2 = points[i + 2], p3 = points[(i + 3) % n];
+        area += 6 * cross(p0, p1) + 3 * cross(p0, p2) + cross(p0, p3)
+              + 3 * cross(p1, p2) + 3 * cross(p1, p3) + 6 * cross(p2, p3);
+    }
+    return fabs(area) / 20.0;
+}
+
+static double speed(const Point p[4], double t) {
+    double u = 1.0 - t;
+    double dx = 3 * (u * u * (p[1].x - p[0].x) + 2 * u * t * (p[2].x - p[1].x) + t * t * (p[3].x - p[2].x));
+    double dy = 3 * (u * u * (p[1].y - p[0].y) + 2 * u * t * (p[2].y - p[1].y) + t * t * (p[3].y - p[2].y));
+    return sqrt(dx * dx + dy * dy);
+}
+
+// 5-point Gauss-Legendre over [t0, t1]
+static double gauss_length(const Point p[4], double t0, double t1) {
+    static const double nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+    static const double weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+    double half = 0.5 * (t1 - t0), mid = 0.5 * (t0 + t1);
+    double sum = 0.0;
+    for (int k = 0; k < 5; ++k) {
+        sum += weights[k] * speed(p, mid + half * nodes[k]);
+    }
+    return sum * half;
+}
+
+static double adaptive_length(const Point p[4], double t0, double t1, double whole, int depth) {
+    double mid = 0.5 * (t0 + t1);
+    double left = gauss_length(p, t0, mid);
+    double right = gauss_length(p, mid, t1);
+    if (depth >= LENGTH_MAX_DEPTH || fabs(left + right - whole) <= LENGTH_TOLERANCE * (left + right)) {
+        return left + right;
+    }
+    return adaptive_length(p, t0, mid, left, depth + 1) + adaptive_length(p, mid, t1, right, depth + 1);
+}
+
+double closed_curve_length(const Point points[], uint32_t segment_count) {
+    double length = 0.0;
+    uint64_t n = 3ull * segment_count;
+    for (uint64_t i = 0; i < n; i += 3) {
+        Point p[4] = { points[i], points[i + 1], points[i + 2], points[(i + 3) % n] };
+        length += adaptive_length(p, 0.0, 1.0, gauss_length(p, 0.0, 1.0), 0);
+    }
+    return length;
+}
+
+bool write_curve_header(FILE* out, uint64_t curve_count) {
+    uint32_t version = BZC_VERSION;
+    return fwrite(BZC_MAGIC, 4, 1, out) == 1 && fwrite(&version, sizeof(version), 1, out) == 1 &&
+           fwrite(&curve_count, sizeof(curve_count), 1, out) == 1;
+}
+
+bool write_curve_record(FILE* out, const Point points[], uint32_t segment_count) {
+    uint32_t header[2] = { segment_count, 0 };
+    return fwrite(header, sizeof(header), 1, out) == 1 &&
+           fwrite(points, sizeof(Point), 3 * segment_count, out) == 3 * segment_count;
+}
+
+// CSV: one "x,y" point per line, curves separated by blank lines, '#' starts a comment.
+// Each curve needs a multiple of three points. Only one curve is held in memory at a time.
+bool import_csv(const char* csv_path, const char* bzc_path) {
+    FILE* in = fopen(csv_path, "r");
+    if (in == NULL) {
+        printf("Hiba: %s nem olvashato\n", csv_path);
+        return false;
+    }
+    // The output is created only once there is something to convert
+    FILE* out = fopen(bzc_path, "wb");
+    if (out == NULL) {
+        printf("Hiba: %s nem irhato\n", bzc_path);
+        fclose(in);
+        return false;
+    }
+    Point* points = NULL;
+    uint32_t count = 0, capacity = 0;
+    uint64_t curves = 0;
+    long line_number = 0;
+    bool ok = write_curve_header(out, curves);
+
+    char line[CSV_LINE_LENGTH];
+    bool at_end = false;
+    while (ok && !at_end) {
+        at_end = fgets(line, sizeof(line), in) == NULL;
+        ++line_number;
+        char* text = at_end ? NULL : line + strspn(line, " \t");
+        bool separator = at_end || *text == '\n' || *text == '\r' || *text == '\0';
+        if (!separator && *text == '#') {
+            continue;
+        }
+        if (separator) {
+            if (count == 0) {
+                continue;
+            }
+            if (count % 3 != 0) {
+                printf("Hiba: %s %ld. soranal vegzodo gorbe pontszama (%u) nem oszthato harommal\n",
+                       csv_path, line_number, count);
+                ok = false;
+                break;
+            }
+            ok = write_curve_record(out, points, count / 3);
+            ++curves;
+            count = 0;
+            continue;
+        }
+        Point p;
+        if (sscanf(text, "%lf , %lf", &p.x, &p.y) != 2) {
+            printf("Hiba: %s %ld. sora nem ertelmezheto\n", csv_path, line_number);
+            ok = false;
+            break;
+        }
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 1024;
+            Point* grown = realloc(points, capacity * sizeof(Point));
+            if (grown == NULL) {
+                ok = false;
+                break;
+            }
+            points = grown;
+        }
+        points[count++] = p;
+    }
+
+    if (ok) {
+        ok = fseek(out, 8, SEEK_SET) == 0 && fwrite(&curves, sizeof(curves), 1, out) == 1;
+    }
+    free(points);
+    fclose(in);
+    if (fclose(out) != 0) ok = false;
+    if (ok) {
+        printf("Importalva: %llu gorbe -> %s\n", (unsigned long long)curves, bzc_path);
+    }
+    return ok;
+}
+
+// --stream: area and length of every curve, one mapped window at a time
+int stream_file(const char* path) {
+    CurveFile file;
+    if (!curve_file_open(&file, path)) {
+        printf("Hiba: %s nem olvashato .bzc fajl\n", path);
+        return 1;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t curves = 0, segments = 0;
+    double total_area = 0.0, total_length = 0.0;
+    uint32_t count;
+    const Point* points;
+    while ((points = curve_file_next(&file, &count)) != NULL) {
+        total_area += closed_curve_area(points, count);
+        total_length += closed_curve_length(points, count);
+        ++curves;
+        segments += count;
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    bool complete = curves == file.curve_count && file.cursor == file.size;
+
+    printf("Gorbek: %llu / %llu    Szegmensek: %llu\n", (unsigned long long)curves,
+           (unsigned long long)file.curve_count, (unsigned long long)segments);
+    printf("Ossz terulet: %.4f    Ossz hossz: %.4f\n", total_area, total_length);
+    printf("Ido: %.3f s    %.1f MB/s    Legnagyobb ablak: %.1f MB\n", seconds,
+           file.size / 1048576.0 / (seconds > 0 ? seconds : 1e-9), file.peak_window / 1048576.0);
+    if (!complete) {
+        printf("Hiba: a fajl csonka vagy serult (%llu. bajtnal)\n", (unsigned long long)file.cursor);
+    }
+    curve_file_close(&file);
+    return complete ? 0 : 1;
+}
+
+// Tangent and curvature field of every curve: steps + 1 samples per segment from one
+// batch pass each. The summary reports the worst breaks at the joins, where consecutive
+// segments should agree in tangent direction (G1) and curvature (G2). A csv_path of "-"
+// only prints the summary.
+int export_curvature(const char* bzc_path, const char* csv_path, int steps) {
+    if (steps < 1) {
+        steps = 1;
+    }
+    CurveFile file;
+    if (!curve_file_open(&file, bzc_path)) {
+        printf("Hiba: %s nem olvashato .bzc fajl\n", bzc_path);
+        return 1;
+    }
+    FILE* out = strcmp(csv_path, "-") == 0 ? NULL : fopen(csv_path, "w");
+    if (out == NULL && strcmp(csv_path, "-") != 0) {
+        printf("Hiba: %s nem irhato\n", csv_path);
+        curve_file_close(&file);
+        return 1;
+    }
+    if (out != NULL) {
+        fprintf(out, "curve,segment,t,x,y,dx,dy,ddx,ddy,curvature\n");
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    PowerBasis basis = { 0 };
+    Arena* scratch = scratch_arena();
+    uint64_t curves = 0, samples = 0;
+    double max_curvature = 0.0, worst_angle = 0.0, worst_jump = 0.0;
+    uint64_t worst_angle_curve = 0, worst_jump_curve = 0;
+    bool ok = true;
+    uint32_t count;
+    const Point* points;
+    while (ok && (points = curve_file_next(&file, &count)) != NULL) {
+        Segment* segments = arena_alloc(scratch, count * sizeof(Segment));
+        CurveSample* field = arena_alloc(scratch, (size_t)count * (steps + 1) * sizeof(CurveSample));
+        uint64_t n = 3ull * count;
+        ok = segments != NULL && field != NULL;
+        if (ok) {
+            for (uint64_t i = 0; i < n; i += 3) {
+                Segment* s = &segments[i / 3];
+                s->p[0] = points[i];
+                s->p[1] = points[i + 1];
+                s->p[2] = points[i + 2];
+                s->p[3] = points[(i + 3) % n];
+            }
+            ok = power_basis_update(&basis, segments, count);
+        }
+        if (ok) {
+            power_basis_sample_chain(&basis, steps, field);
+            for (uint32_t i = 0; i < count; ++i) {
+                const CurveSample* row = &field[(size_t)i * (steps + 1)];
+                for (int j = 0; j <= steps; ++j) {
+                    max_curvature = fmax(max_curvature, fabs(row[j].curvature));
+                    if (out != NULL) {
+                        fprintf(out, "%llu,%u,%.6f,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\n", (unsigned long long)curves, i,
+                                (double)j / steps, row[j].position.x, row[j].position.y, row[j].d1.x, row[j].d1.y,
+                                row[j].d2.x, row[j].d2.y, row[j].curvature);
+                    }
+                }
+                // End of segment i against the start of the next one
+                const CurveSample* end = &row[steps];
+                const CurveSample* next = &field[(size_t)((i + 1) % count) * (steps + 1)];
+                double angle = fabs(atan2(cross(end->d1, next->d1), end->d1.x * next->d1.x + end->d1.y * next->d1.y));
+                double jump = fabs(end->curvature - next->curvature);
+                if (angle > worst_angle) {
+                    worst_angle = angle;
+                    worst_angle_curve = curves;
+                }
+                if (jump > worst_jump) {
+                    worst_jump = jump;
+                    worst_jump_curve = curves;
+                }
+            }
+            samples += (uint64_t)count * (steps + 1);
+            ++curves;
+        }
+        // Each curve is a job of its own; the reset also returns oversized ones to the heap
+        arena_reset(scratch);
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    bool complete = ok && curves == file.curve_count && file.cursor == file.size;
+    if (out != NULL && fclose(out) != 0) {
+        complete = false;
+    }
+
+    printf("Gorbek: %llu / %llu    Mintak: %llu    Ido: %.3f s (%.1f ns/minta)\n", (unsigned long long)curves,
+           (unsigned long long)file.curve_count, (unsigned long long)samples, seconds,
+           seconds * 1e9 / (samples > 0 ? samples : 1));
+    printf("Max gorbulet: %.6g    Legnagyobb erintotores: %.4f fok (%llu. gorbe)    "
+           "Legnagyobb gorbuletugras: %.6g (%llu. gorbe)\n",
+           max_curvature, worst_angle * 180.0 / M_PI, (unsigned long long)worst_angle_curve, worst_jump,
+           (unsigned long long)worst_jump_curve);
+    if (!complete) {
+        printf("Hiba: a fajl csonka vagy serult (%llu. bajtnal)\n", (unsigned long long)file.cursor);
+    }
+    power_basis_free(&basis);
+    curve_file_close(&file);
+    return complete ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// .bzc layout, native byte order:
+//   header: char magic[4] = "BZC1", uint32_t version, uint64_t curve_count
+//   record: uint32_t segment_count, uint32_t reserved, Point points[3 * segment_count]
+// A record is one closed curve of cubics; segment i is points[3i .. 3i + 3] and the last
+// one wraps around to points[0]. Every record starts 8-byte aligned, so the points can
+// be used in place from the mapping.
+#define BZC_MAGIC "BZC1"
+#define BZC_VERSION 1u
+#define BZC_WINDOW_SIZE (64u << 20)
+
+typedef struct CurveFile {
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+    uint64_t size;
+    uint64_t curve_count;
+    uint64_t cursor;            // file offset of the next record
+    unsigned char* window;      // mapped view, at most BZC_WINDOW_SIZE unless one record is larger
+    uint64_t window_offset;
+    uint64_t window_length;
+    uint64_t peak_window;
+} CurveFile;
+
+bool curve_file_open(CurveFile* file, const char* path);
+void curve_file_close(CurveFile* file);
+const Point* curve_file_next(CurveFile* file, uint32_t* segment_count);
+bool write_curve_header(FILE* out, uint64_t curve_count);
+bool write_curve_record(FILE* out, const Point points[], uint32_t segment_count);
+bool import_csv(const char* csv_path, const char* bzc_path);
+double closed_curve_area(const Point points[], uint32_t segment_count);
+double closed_curve_length(const Point points[], uint32_t segment_count);
+int stream_file(const char* path);
+int export_curvature(const char* bzc_path, const char* csv_path, int steps);
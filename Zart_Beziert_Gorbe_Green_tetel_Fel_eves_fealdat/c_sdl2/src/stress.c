@@ -0,0 +1,458 @@
+#include "stress.h"
+#include "area.h"
+#include "arena.h"
+#include "bezier.h"
+#include "bezier_degree.h"
+#include "conic.h"
+#include "loops.h"
+#include "utils.h"
+#include <SDL2/SDL.h>
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STRESS_MAX_DEGREE 40
+#define STRESS_LOW_DEGREE 12
+#define STRESS_PARAMS 24
+#define STRESS_AREA_STEPS 64
+#define STRESS_REPORTED_FAILURES 8
+#define STRESS_HUGE 1e150
+#define STRESS_FAR 1e9
+
+typedef enum CaseKind {
+    CASE_RANDOM,
+    CASE_COINCIDENT,
+    CASE_COLLINEAR,
+    CASE_ZERO_WEIGHTS,
+    CASE_FAR,
+    CASE_HUGE,
+    CASE_HIGH_DEGREE,
+    CASE_KIND_COUNT
+} CaseKind;
+
+static const char* CASE_NAMES[CASE_KIND_COUNT] = {
+    "veletlen", "egybeeso", "kollinearis", "nulla suly", "tavoli", "hatalmas", "magas fok"
+};
+
+typedef enum Invariant {
+    INV_FINITE,
+    INV_HULL,
+    INV_AFFINE,
+    INV_REVERSAL,
+    INV_BATCH,
+    INV_AREA_SIGN,
+    INV_COUNT
+} Invariant;
+
+static const char* INVARIANT_NAMES[INV_COUNT] = {
+    "veges ertek", "konvex burok", "affin invariancia", "megforditas", "batch = egyenkenti", "terulet elojele"
+};
+
+typedef enum Kernel {
+    KERNEL_BEZIER,
+    KERNEL_RATIONAL,
+    KERNEL_CUBIC,
+    KERNEL_AREA,
+    KERNEL_MOMENTS,
+    KERNEL_CONIC,
+    KERNEL_COUNT
+} Kernel;
+
+static const char* KERNEL_NAMES[KERNEL_COUNT] = {
+    "bezier_eval", "rational_bezier_eval", "bezier", "calculate_area", "segment_moments", "conic_eval"
+};
+
+typedef struct StressCase {
+    CaseKind kind;
+    int degree;
+    Point control[STRESS_MAX_DEGREE + 1];
+    double weights[STRESS_MAX_DEGREE + 1];
+    double scale;           // largest coordinate magnitude, the yardstick of rounding errors
+} StressCase;
+
+typedef struct StressStats {
+    long cases[CASE_KIND_COUNT];
+    long failures[CASE_KIND_COUNT][INV_COUNT];
+    long checks;
+    long failure_total;
+    double worst_ns[KERNEL_COUNT];
+    double total_ns[KERNEL_COUNT];
+    long timed[KERNEL_COUNT];
+} StressStats;
+
+// Rotation, non-uniform scale and shear, then a shift; the determinant is kept away from zero
+typedef struct Affine {
+    double a, b, c, d, ex, ey;
+} Affine;
+
+static unsigned stress_state = 20240611u;
+
+static double stress_random(double lo, double hi) {
+    return random_range(&stress_state, lo, hi);
+}
+
+static int stress_random_int(int lo, int hi) {
+    return lo + (int)stress_random(0.0, hi - lo + 1 - 1e-9);
+}
+
+static Point apply(const Affine* m, Point p) {
+    Point q = { m->a * p.x + m->b * p.y + m->ex, m->c * p.x + m->d * p.y + m->ey };
+    return q;
+}
+
+static bool finite_point(Point p) {
+    return isfinite(p.x) && isfinite(p.y);
+}
+
+static double distance(Point p, Point q) {
+    return hypot(p.x - q.x, p.y - q.y);
+}
+
+static void fail(StressStats* stats, const StressCase* c, Invariant invariant, const char* kernel, double t) {
+    ++stats->failures[c->kind][invariant];
+    if (stats->failure_total++ < STRESS_REPORTED_FAILURES) {
+        printf("  HIBA %s: %s, %s eset, fokszam %d, t = %.17g\n", INVARIANT_NAMES[invariant], kernel,
+               CASE_NAMES[c->kind], c->degree, t);
+    }
+}
+
+static void expect(StressStats* stats, const StressCase* c, Invariant invariant, const char* kernel, double t, bool ok) {
+    ++stats->checks;
+    if (!ok) {
+        fail(stats, c, invariant, kernel, t);
+    }
+}
+
+static void record_time(StressStats* stats, Kernel kernel, Uint64 start, int evaluations) {
+    double ns = (SDL_GetPerformanceCounter() - start) * 1e9 / (double)SDL_GetPerformanceFrequency() / evaluations;
+    if (ns > stats->worst_ns[kernel]) {
+        stats->worst_ns[kernel] = ns;
+    }
+    stats->total_ns[kernel] += ns;
+    ++stats->timed[kernel];
+}
+
+static void generate_case(StressCase* c, CaseKind kind) {
+    c->kind = kind;
+    c->degree = kind == CASE_HIGH_DEGREE ? stress_random_int(STRESS_LOW_DEGREE + 1, STRESS_MAX_DEGREE)
+                                         : stress_random_int(1, STRESS_LOW_DEGREE);
+    double size = kind == CASE_HUGE ? STRESS_HUGE : stress_random(1e-3, 1e3);
+    Point offset = { 0.0, 0.0 };
+    if (kind == CASE_FAR) {
+        offset.x = stress_random(-STRESS_FAR, STRESS_FAR);
+        offset.y = stress_random(-STRESS_FAR, STRESS_FAR);
+    }
+    Point direction = { stress_random(-1, 1), stress_random(-1, 1) };
+    for (int i = 0; i <= c->degree; ++i) {
+        Point p = { stress_random(-size, size), stress_random(-size, size) };
+        if (kind == CASE_COLLINEAR) {
+            double s = stress_random(-size, size);
+            p.x = s * direction.x;
+            p.y = s * direction.y;
+        }
+        // Coincident: runs of equal points, now and then all of them
+        if (kind == CASE_COINCIDENT && i > 0 && stress_random(0, 1) < 0.6) {
+            p = c->control[i - 1];
+        } else {
+            p.x += offset.x;
+            p.y += offset.y;
+        }
+        c->control[i] = p;
+        c->weights[i] = stress_random(0.05, 20.0);
+        if (kind == CASE_ZERO_WEIGHTS && stress_random(0, 1) < 0.4) {
+            c->weights[i] = 0.0;
+        }
+    }
+    if (kind == CASE_ZERO_WEIGHTS && stress_random(0, 1) < 0.1) {
+        for (int i = 0; i <= c->degree; ++i) {
+            c->weights[i] = 0.0;
+        }
+    }
+    c->scale = 1.0;
+    for (int i = 0; i <= c->degree; ++i) {
+        c->scale = fmax(c->scale, fmax(fabs(c->control[i].x), fabs(c->control[i].y)));
+    }
+}
+
+// Ends, the Horner switch at 0.5 and its neighbours, extreme values near the ends, random rest
+static void generate_params(double t[STRESS_PARAMS]) {
+    static const double fixed[] = { 0.0, 1.0, 0.5, 1e-300, 1e-17, 1.0 - 1e-16 };
+    int n = 0;
+    for (; n < (int)(sizeof(fixed) / sizeof(fixed[0])); ++n) {
+        t[n] = fixed[n];
+    }
+    t[n++] = nextafter(0.5, 0.0);
+    t[n++] = nextafter(0.5, 1.0);
+    while (n < STRESS_PARAMS) {
+        t[n++] = stress_random(0.0, 1.0);
+    }
+}
+
+// Homogeneous denominator of the rational curve at t, summed term by term in the usual
+// Bernstein form; for nonnegative weights it is zero only where the curve is undefined
+static double rational_denominator(const StressCase* c, double t) {
+    double sum = 0.0, binomial = 1.0;
+    for (int i = 0; i <= c->degree; ++i) {
+        if (i > 0) {
+            binomial = binomial * (c->degree - i + 1) / i;
+        }
+        sum += c->weights[i] * binomial * pow(t, i) * pow(1.0 - t, c->degree - i);
+    }
+    return sum;
+}
+
+// Bounding box of the control points that carry weight: contains the convex hull, so a
+// point outside it is outside the hull as well
+static void hull_box(const StressCase* c, bool weighted, Point* min, Point* max) {
+    *min = (Point){ INFINITY, INFINITY };
+    *max = (Point){ -INFINITY, -INFINITY };
+    for (int i = 0; i <= c->degree; ++i) {
+        if (weighted && c->weights[i] == 0.0) {
+            continue;
+        }
+        min->x = fmin(min->x, c->control[i].x);
+        min->y = fmin(min->y, c->control[i].y);
+        max->x = fmax(max->x, c->control[i].x);
+        max->y = fmax(max->y, c->control[i].y);
+    }
+}
+
+static bool inside_box(Point p, Point min, Point max, double tolerance) {
+    return p.x >= min.x - tolerance && p.x <= max.x + tolerance && p.y >= min.y - tolerance && p.y <= max.y + tolerance;
+}
+
+static Affine random_affine(const StressCase* c) {
+    double angle = stress_random(0, 2 * M_PI);
+    double sx = stress_random(0.25, 4.0), sy = stress_random(0.25, 4.0), shear = stress_random(-1, 1);
+    Affine m = { sx * cos(angle), sx * (shear * cos(angle) - sin(angle)),
+                 sy * sin(angle), sy * (shear * sin(angle) + cos(angle)),
+                 stress_random(-1, 1) * c->scale, stress_random(-1, 1) * c->scale };
+    return m;
+}
+
+static void stress_evaluators(StressStats* stats, const StressCase* c, const double t[]) {
+    Point reversed[STRESS_MAX_DEGREE + 1], mapped[STRESS_MAX_DEGREE + 1];
+    double reversed_weights[STRESS_MAX_DEGREE + 1];
+    Affine m = random_affine(c);
+    for (int i = 0; i <= c->degree; ++i) {
+        reversed[i] = c->control[c->degree - i];
+        reversed_weights[i] = c->weights[c->degree - i];
+        mapped[i] = apply(&m, c->control[i]);
+    }
+    // Rounding grows with the degree and the coordinate magnitude
+    double tolerance = 64.0 * DBL_EPSILON * (c->degree + 1) * c->scale;
+    double mapped_tolerance = 8.0 * tolerance * (fabs(m.a) + fabs(m.b) + fabs(m.c) + fabs(m.d) + 1.0);
+    Point min, max, weighted_min, weighted_max;
+    hull_box(c, false, &min, &max);
+    hull_box(c, true, &weighted_min, &weighted_max);
+
+    Point batch[STRESS_PARAMS], single[STRESS_PARAMS], rational[STRESS_PARAMS], rational_batch[STRESS_PARAMS];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        single[k] = bezier_eval(c->control, c->degree, t[k]);
+    }
+    record_time(stats, KERNEL_BEZIER, start, STRESS_PARAMS);
+    start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        rational[k] = rational_bezier_eval(c->control, c->weights, c->degree, t[k]);
+    }
+    record_time(stats, KERNEL_RATIONAL, start, STRESS_PARAMS);
+    bezier_eval_batch(c->control, c->degree, t, STRESS_PARAMS, batch);
+    rational_bezier_eval_batch(c->control, c->weights, c->degree, t, STRESS_PARAMS, rational_batch);
+
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        Point p = single[k];
+        expect(stats, c, INV_FINITE, "bezier_eval", t[k], finite_point(p));
+        expect(stats, c, INV_BATCH, "bezier_eval_batch", t[k], distance(batch[k], p) <= tolerance);
+        expect(stats, c, INV_HULL, "bezier_eval", t[k], inside_box(p, min, max, tolerance));
+        expect(stats, c, INV_REVERSAL, "bezier_eval", t[k],
+               distance(bezier_eval(reversed, c->degree, 1.0 - t[k]), p) <= 2.0 * tolerance);
+        expect(stats, c, INV_AFFINE, "bezier_eval", t[k],
+               distance(bezier_eval(mapped, c->degree, t[k]), apply(&m, p)) <= mapped_tolerance);
+
+        // Where all weights vanish the curve is undefined; the kernel only has to stay finite
+        Point r = rational[k];
+        expect(stats, c, INV_FINITE, "rational_bezier_eval", t[k], finite_point(r));
+        expect(stats, c, INV_BATCH, "rational_bezier_eval_batch", t[k],
+               distance(rational_batch[k], r) <= tolerance || (!finite_point(r) && !finite_point(rational_batch[k])));
+        if (rational_denominator(c, t[k]) <= 0.0) {
+            continue;
+        }
+        // Near a zero denominator the rounding of the weighted sums is amplified
+        double amplified = tolerance * fmax(1.0, 1e-3 / fmin(1e-3, rational_denominator(c, t[k])));
+        expect(stats, c, INV_HULL, "rational_bezier_eval", t[k], inside_box(r, weighted_min, weighted_max, amplified));
+        // 1 - t rounds for t near 0, which moves the point where the weights vanish
+        expect(stats, c, INV_REVERSAL, "rational_bezier_eval", t[k], 1.0 - (1.0 - t[k]) != t[k] ||
+               distance(rational_bezier_eval(reversed, reversed_weights, c->degree, 1.0 - t[k]), r) <= 2.0 * amplified);
+        expect(stats, c, INV_AFFINE, "rational_bezier_eval", t[k],
+               distance(rational_bezier_eval(mapped, c->weights, c->degree, t[k]), apply(&m, r)) <=
+                   mapped_tolerance * amplified / tolerance);
+    }
+}
+
+// Closed cubic curves: the area kernels are translation and orientation free, and scale with
+// |det A| under an affine map. Huge coordinates are left out: the moments are fourth powers.
+static void stress_areas(StressStats* stats, const StressCase* c, const double t[]) {
+    if (c->kind == CASE_HUGE) {
+        return;
+    }
+    Point points[N_POINTS], reversed[N_POINTS], mapped[N_POINTS];
+    Affine m = random_affine(c);
+    m.ex = stress_random(-1, 1) * STRESS_FAR;
+    m.ey = stress_random(-1, 1) * STRESS_FAR;
+    double det = fabs(m.a * m.d - m.b * m.c);
+    for (int i = 0; i < N_POINTS; ++i) {
+        points[i] = c->control[i % (c->degree + 1)];
+        reversed[N_POINTS - 1 - i] = points[i];
+    }
+    for (int i = 0; i < N_POINTS; ++i) {
+        mapped[i] = apply(&m, points[i]);
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Point cubic[STRESS_PARAMS];
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        cubic[k] = bezier(points[0], points[1], points[2], points[3], t[k]);
+    }
+    record_time(stats, KERNEL_CUBIC, start, STRESS_PARAMS);
+    Point min, max;
+    StressCase hull = *c;
+    hull.degree = N_POINTS - 1;
+    for (int i = 0; i < N_POINTS; ++i) {
+        hull.control[i] = points[i];
+    }
+    hull_box(&hull, false, &min, &max);
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        expect(stats, c, INV_FINITE, "bezier", t[k], finite_point(cubic[k]));
+        expect(stats, c, INV_HULL, "bezier", t[k], inside_box(cubic[k], min, max, 256.0 * DBL_EPSILON * c->scale));
+    }
+
+    double error;
+    start = SDL_GetPerformanceCounter();
+    double area = calculate_area(points, STRESS_AREA_STEPS, &error);
+    record_time(stats, KERNEL_AREA, start, 1);
+    Segment segments[N_POINTS], reversed_segments[N_POINTS], mapped_segments[N_POINTS];
+    build_segments(points, N_POINTS, segments);
+    build_segments(reversed, N_POINTS, reversed_segments);
+    build_segments(mapped, N_POINTS, mapped_segments);
+    Moments moments, reversed_moments, mapped_moments;
+    start = SDL_GetPerformanceCounter();
+    segment_moments(segments, N_POINTS, &moments);
+    record_time(stats, KERNEL_MOMENTS, start, 1);
+    segment_moments(reversed_segments, N_POINTS, &reversed_moments);
+    segment_moments(mapped_segments, N_POINTS, &mapped_moments);
+
+    // Every term of the sums is a product of two coordinates; the shift adds STRESS_FAR to them
+    double size = fmax(max.x - min.x, max.y - min.y);
+    double area_tolerance = 1e-12 * size * (size + fmax(c->scale, STRESS_FAR)) * STRESS_AREA_STEPS;
+    expect(stats, c, INV_FINITE, "calculate_area", 0.0, isfinite(area) && area >= 0.0);
+    expect(stats, c, INV_FINITE, "segment_moments", 0.0, isfinite(moments.area) && moments.area >= 0.0 &&
+                                                         (moments.area == 0.0 || finite_point(moments.centroid)));
+    expect(stats, c, INV_REVERSAL, "calculate_area", 0.0,
+           fabs(calculate_area(reversed, STRESS_AREA_STEPS, &error) - area) <= area_tolerance);
+    expect(stats, c, INV_REVERSAL, "segment_moments", 0.0, fabs(reversed_moments.area - moments.area) <= area_tolerance);
+    expect(stats, c, INV_AFFINE, "calculate_area", 0.0,
+           fabs(calculate_area(mapped, STRESS_AREA_STEPS, &error) - det * area) <= 64.0 * det * area_tolerance);
+    expect(stats, c, INV_AFFINE, "segment_moments", 0.0,
+           fabs(mapped_moments.area - det * moments.area) <= 64.0 * det * area_tolerance);
+
+    // Signed loop areas turn with the outline, the true area stays
+    Point outline[N_POINTS * 16], reversed_outline[N_POINTS * 16];
+    int count = tessellate_outline(segments, N_POINTS, 16, outline);
+    for (int i = 0; i < count; ++i) {
+        reversed_outline[i] = outline[count - 1 - i];
+    }
+    LoopAreas forward, backward;
+    Arena* scratch = scratch_arena();
+    size_t mark = arena_mark(scratch);
+    if (decompose_loops(outline, count, &forward) && decompose_loops(reversed_outline, count, &backward)) {
+        expect(stats, c, INV_AREA_SIGN, "decompose_loops", 0.0,
+               fabs(forward.signed_area + backward.signed_area) <= area_tolerance);
+        expect(stats, c, INV_REVERSAL, "decompose_loops", 0.0,
+               fabs(forward.true_area - backward.true_area) <= area_tolerance);
+    }
+    arena_release(scratch, mark);
+}
+
+static void stress_conics(StressStats* stats, const StressCase* c, const double t[]) {
+    int n = c->degree + 1;
+    Point p0 = c->control[0], p1 = c->control[1 % n], p2 = c->control[2 % n];
+    // Zero, small, parabolic and strongly hyperbolic weights
+    double w = c->kind == CASE_ZERO_WEIGHTS ? 0.0 : exp(stress_random(-8.0, 8.0));
+    Conic conic = conic_from_points(p0, p1, p2, w);
+    Conic reversed = conic_from_points(p2, p1, p0, w);
+    Point min, max;
+    StressCase hull = *c;
+    hull.degree = 2;
+    hull.control[0] = p0;
+    hull.control[1] = p1;
+    hull.control[2] = p2;
+    hull_box(&hull, false, &min, &max);
+    double tolerance = 64.0 * DBL_EPSILON * c->scale * fmax(1.0, w);
+
+    Point samples[STRESS_PARAMS];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        samples[k] = conic_eval(&conic, t[k]);
+    }
+    record_time(stats, KERNEL_CONIC, start, STRESS_PARAMS);
+    for (int k = 0; k < STRESS_PARAMS; ++k) {
+        expect(stats, c, INV_FINITE, "conic_eval", t[k], finite_point(samples[k]));
+        expect(stats, c, INV_HULL, "conic_eval", t[k], inside_box(samples[k], min, max, tolerance));
+        expect(stats, c, INV_REVERSAL, "conic_eval", t[k],
+               distance(conic_eval(&reversed, 1.0 - t[k]), samples[k]) <= 2.0 * tolerance);
+    }
+    if (c->kind != CASE_HUGE) {
+        double green = conic_green(&conic);
+        expect(stats, c, INV_FINITE, "conic_green", 0.0, isfinite(green));
+        expect(stats, c, INV_AREA_SIGN, "conic_green", 0.0,
+               fabs(green + conic_green(&reversed)) <= 1e-12 * c->scale * c->scale * fmax(1.0, w));
+    }
+}
+
+static void print_report(const StressStats* stats, int rounds, double seconds) {
+    printf("%-12s %8s", "eset", "db");
+    for (int i = 0; i < INV_COUNT; ++i) {
+        printf("  %s", INVARIANT_NAMES[i]);
+    }
+    printf("\n");
+    for (int k = 0; k < CASE_KIND_COUNT; ++k) {
+        printf("%-12s %8ld", CASE_NAMES[k], stats->cases[k]);
+        for (int i = 0; i < INV_COUNT; ++i) {
+            printf("  %*ld", (int)strlen(INVARIANT_NAMES[i]), stats->failures[k][i]);
+        }
+        printf("\n");
+    }
+    printf("\n%-22s %12s %12s\n", "kernel", "atlag ns", "legrosszabb ns");
+    for (int k = 0; k < KERNEL_COUNT; ++k) {
+        if (stats->timed[k] > 0) {
+            printf("%-22s %12.1f %12.1f\n", KERNEL_NAMES[k], stats->total_ns[k] / stats->timed[k], stats->worst_ns[k]);
+        }
+    }
+    printf("\n%d eset, %ld ellenorzes %.2f s alatt (%.0f ellenorzes/s), %ld hiba\n", rounds, stats->checks, seconds,
+           stats->checks / fmax(seconds, 1e-9), stats->failure_total);
+}
+
+// --stress: random and adversarial control sets through the numerical kernels, checking
+// invariants instead of reference values. Exits non-zero if any of them is violated.
+int run_stress(int rounds) {
+    static StressStats stats;
+    StressCase c;
+    double t[STRESS_PARAMS];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int round = 0; round < rounds; ++round) {
+        generate_case(&c, (CaseKind)(round % CASE_KIND_COUNT));
+        generate_params(t);
+        ++stats.cases[c.kind];
+        stress_evaluators(&stats, &c, t);
+        stress_areas(&stats, &c, t);
+        stress_conics(&stats, &c, t);
+        arena_reset(scratch_arena());
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    print_report(&stats, rounds, seconds);
+    scratch_arena_shutdown();
+    return stats.failure_total == 0 ? 0 : 1;
+}
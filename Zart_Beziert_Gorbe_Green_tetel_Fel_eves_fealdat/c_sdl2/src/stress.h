@@ -0,0 +1,5 @@
+#pragma once
+
+#define STRESS_DEFAULT_ROUNDS 20000
+
+int run_stress(int rounds);
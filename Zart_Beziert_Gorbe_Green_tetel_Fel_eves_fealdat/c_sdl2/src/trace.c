@@ -0,0 +1,215 @@
+#include "trace.h"
+#include "area.h"
+#include "graphics.h"
+#include "arena.h"
+#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct TraceEvent {
+    uint32_t time_ms;
+    uint16_t point;
+    int16_t x;
+    int16_t y;
+} TraceEvent;
+
+static void put_u16(unsigned char* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+static void put_u32(unsigned char* out, uint32_t value) {
+    put_u16(out, value & 0xFFFF);
+    put_u16(out + 2, value >> 16);
+}
+
+// IEEE 754 bits of the double, low word first like the integers
+static void put_f64(unsigned char* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u32(out, (uint32_t)bits);
+    put_u32(out + 4, (uint32_t)(bits >> 32));
+}
+
+static uint16_t get_u16(const unsigned char* in) {
+    return (uint16_t)(in[0] | in[1] << 8);
+}
+
+static uint32_t get_u32(const unsigned char* in) {
+    return get_u16(in) | (uint32_t)get_u16(in + 2) << 16;
+}
+
+static double get_f64(const unsigned char* in) {
+    uint64_t bits = get_u32(in) | (uint64_t)get_u32(in + 4) << 32;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool trace_begin(TraceWriter* writer, const char* path, const Point points[], int steps) {
+    writer->file = fopen(path, "wb");
+    writer->start_ms = SDL_GetTicks();
+    writer->events = 0;
+    if (writer->file == NULL) {
+        return false;
+    }
+    unsigned char header[8];
+    memcpy(header, TRACE_MAGIC, 4);
+    put_u16(header + 4, N_POINTS);
+    put_u16(header + 6, (uint16_t)steps);
+    fwrite(header, sizeof(header), 1, writer->file);
+    for (int i = 0; i < N_POINTS; ++i) {
+        unsigned char xy[16];
+        put_f64(xy, points[i].x);
+        put_f64(xy + 8, points[i].y);
+        fwrite(xy, sizeof(xy), 1, writer->file);
+    }
+    return true;
+}
+
+// Mouse coordinates fit in 16 bits for any window this program opens
+void trace_record(TraceWriter* writer, int point_index, int x, int y) {
+    if (writer->file == NULL) {
+        return;
+    }
+    unsigned char event[TRACE_EVENT_SIZE];
+    put_u32(event, SDL_GetTicks() - writer->start_ms);
+    put_u16(event + 4, (uint16_t)point_index);
+    put_u16(event + 6, (uint16_t)(int16_t)x);
+    put_u16(event + 8, (uint16_t)(int16_t)y);
+    fwrite(event, sizeof(event), 1, writer->file);
+    ++writer->events;
+}
+
+void trace_end(TraceWriter* writer) {
+    if (writer->file == NULL) {
+        return;
+    }
+    fclose(writer->file);
+    writer->file = NULL;
+    printf("\nNyomvonal mentve: %ld esemeny\n", writer->events);
+}
+
+// Reads the header into points/steps; returns the file positioned at the first event
+static FILE* open_trace(const char* path, Point points[], int* steps) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    unsigned char header[8];
+    if (fread(header, sizeof(header), 1, file) != 1 || memcmp(header, TRACE_MAGIC, 4) != 0 ||
+        get_u16(header + 4) != N_POINTS) {
+        fclose(file);
+        return NULL;
+    }
+    *steps = get_u16(header + 6);
+    for (int i = 0; i < N_POINTS; ++i) {
+        unsigned char xy[16];
+        if (fread(xy, sizeof(xy), 1, file) != 1) {
+            fclose(file);
+            return NULL;
+        }
+        points[i].x = get_f64(xy);
+        points[i].y = get_f64(xy + 8);
+    }
+    return file;
+}
+
+static bool read_event(FILE* file, TraceEvent* event) {
+    unsigned char raw[TRACE_EVENT_SIZE];
+    if (fread(raw, sizeof(raw), 1, file) != 1) {
+        return false;
+    }
+    event->time_ms = get_u32(raw);
+    event->point = get_u16(raw + 4);
+    event->x = (int16_t)get_u16(raw + 6);
+    event->y = (int16_t)get_u16(raw + 8);
+    return event->point < N_POINTS;
+}
+
+// Session restore: the control points as they were when the recording stopped
+bool trace_final_points(const char* path, Point points[], int* steps) {
+    FILE* file = open_trace(path, points, steps);
+    if (file == NULL) {
+        return false;
+    }
+    TraceEvent event;
+    while (read_event(file, &event)) {
+        points[event.point].x = event.x;
+        points[event.point].y = event.y;
+    }
+    fclose(file);
+    return true;
+}
+
+static int compare_double(const void* lhs, const void* rhs) {
+    double a = *(const double*)lhs, b = *(const double*)rhs;
+    return (a > b) - (a < b);
+}
+
+static double percentile(const double sorted[], long count, double p) {
+    long index = (long)(p * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+// --replay: every recorded move goes through calculate_area() and the software raster
+// back to back, without event polling or vsync, and is timed on its own
+int replay_trace(const char* path) {
+    Point points[N_POINTS];
+    int steps;
+    FILE* file = open_trace(path, points, &steps);
+    if (file == NULL) {
+        printf("Hiba: %s nem olvashato nyomvonal\n", path);
+        return 1;
+    }
+    if (!graphics_init(NULL)) {
+        fclose(file);
+        return 1;
+    }
+
+    long capacity = 1024, count = 0;
+    double* latency_us = malloc(capacity * sizeof(double));
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    uint32_t session_ms = 0;
+    double total_area = 0.0;
+    TraceEvent event;
+    Uint64 replay_start = SDL_GetPerformanceCounter();
+    while (latency_us != NULL && read_event(file, &event)) {
+        if (count == capacity) {
+            capacity *= 2;
+            double* grown = realloc(latency_us, capacity * sizeof(double));
+            if (grown == NULL) {
+                break;
+            }
+            latency_us = grown;
+        }
+        arena_reset(scratch_arena());
+        Uint64 start = SDL_GetPerformanceCounter();
+        points[event.point].x = event.x;
+        points[event.point].y = event.y;
+        double error;
+        total_area += calculate_area(points, steps, &error);
+        rasterize_scene(points, steps);
+        latency_us[count++] = (SDL_GetPerformanceCounter() - start) * 1e6 / frequency;
+        session_ms = event.time_ms;
+    }
+    double replay_ms = (SDL_GetPerformanceCounter() - replay_start) * 1e3 / frequency;
+    fclose(file);
+    graphics_shutdown();
+
+    if (count == 0) {
+        printf("A nyomvonal nem tartalmaz esemenyt\n");
+        free(latency_us);
+        return latency_us == NULL ? 1 : 0;
+    }
+    qsort(latency_us, count, sizeof(double), compare_double);
+    printf("Esemenyek: %ld    Eredeti munkamenet: %.2f s    Visszajatszas: %.2f ms\n",
+           count, session_ms / 1000.0, replay_ms);
+    printf("Kesleltetes (us)  p50: %.1f  p90: %.1f  p99: %.1f  max: %.1f\n",
+           percentile(latency_us, count, 0.50), percentile(latency_us, count, 0.90),
+           percentile(latency_us, count, 0.99), latency_us[count - 1]);
+    printf("Terulet ellenorzo osszeg: %.5f\n", total_area);
+    arena_print_stats(scratch_arena(), "Keret memoria");
+    free(latency_us);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "types.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// .bzt layout, little endian:
+//   header: char magic[4] = "BZT1", uint16_t n_points, uint16_t steps, then n_points
+//           starting positions as two IEEE 754 doubles each
+//   event:  uint32_t milliseconds since recording started, uint16_t point index,
+//           int16_t x, int16_t y (10 bytes)
+#define TRACE_MAGIC "BZT1"
+#define TRACE_EVENT_SIZE 10
+
+typedef struct TraceWriter {
+    FILE* file;
+    uint32_t start_ms;
+    long events;
+} TraceWriter;
+
+bool trace_begin(TraceWriter* writer, const char* path, const Point points[], int steps);
+void trace_record(TraceWriter* writer, int point_index, int x, int y);
+void trace_end(TraceWriter* writer);
+bool trace_final_points(const char* path, Point points[], int* steps);
+int replay_trace(const char* path);
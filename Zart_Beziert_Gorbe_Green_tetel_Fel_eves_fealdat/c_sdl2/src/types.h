@@ -1,10 +1,28 @@
 #pragma once
 
 #define POINT_RADIUS 10.0
+#define STROKE_HALF_WIDTH 6.0
 #define N_POINTS 4
 #define FILENAME "area_log.txt"
+#define WINDOW_WIDTH 800
+#define WINDOW_HEIGHT 600
 
 typedef struct Point {
     double x;
     double y;
 } Point;
+
+// Storage for the float32 path; control points stay double
+typedef struct PointF {
+    float x;
+    float y;
+} PointF;
+
+typedef enum Precision {
+    PRECISION_DOUBLE,
+    PRECISION_FLOAT
+} Precision;
+
+typedef struct Segment {
+    Point p[4];
+} Segment;
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "profile.h"
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
@@ -9,6 +10,13 @@ void get_timestamp(char* buffer, size_t size) {
     strftime(buffer, size, "%Y-%m-%d %H:%M:%S", t);
 }
 
+// Linear congruential generator behind the reproducible data of --bench, --verify and
+// --stress: the same seed gives the same curves on every platform
+double random_range(unsigned* state, double lo, double hi) {
+    *state = *state * 1664525u + 1013904223u;
+    return lo + (hi - lo) * ((*state >> 8) / 16777216.0);
+}
+
 bool points_changed(Point old_points[], Point new_points[]) {
     for (int i = 0; i < N_POINTS; ++i) {
         if (old_points[i].x != new_points[i].x || old_points[i].y != new_points[i].y) {
@@ -18,7 +26,8 @@ bool points_changed(Point old_points[], Point new_points[]) {
     return false;
 }
 
-void save_area_to_file(double area, double error) {
+void save_area_to_file(double area, double error, const Moments* moments) {
+    PROFILE_SCOPE("save_area_to_file");
     FILE* file = fopen(FILENAME, "a");
     if (file == NULL) {
         printf("Hiba a fájl megnyitásakor!\n");
@@ -27,6 +36,34 @@ void save_area_to_file(double area, double error) {
 
     char timestamp[64];
     get_timestamp(timestamp, sizeof(timestamp));
-    fprintf(file, "[%s] Terület: %.2f pixel^2   Közelítési hiba: %.5f\n", timestamp, area, error);
+    fprintf(file, "[%s] Terület: %.2f pixel^2   Közelítési hiba: %.5f", timestamp, area, error);
+    if (moments != NULL) {
+        fprintf(file, "   Súlypont: (%.2f, %.2f)   Ixx: %.2f   Iyy: %.2f   Ixy: %.2f",
+                moments->centroid.x, moments->centroid.y, moments->ixx, moments->iyy, moments->ixy);
+    }
+    fprintf(file, "\n");
+    fclose(file);
+}
+
+// Only self-intersecting curves get a line; there the plain area can be misleading
+void save_loops_to_file(const LoopAreas* loops) {
+    if (loops->crossing_count == 0) {
+        return;
+    }
+    FILE* file = fopen(FILENAME, "a");
+    if (file == NULL) {
+        printf("Hiba a fájl megnyitásakor!\n");
+        return;
+    }
+
+    char timestamp[64];
+    get_timestamp(timestamp, sizeof(timestamp));
+    fprintf(file, "[%s] Önmetszés: %d pont, %d hurok   Hurkok előjeles területe:",
+            timestamp, loops->crossing_count, loops->loop_count);
+    int reported = loops->loop_count < MAX_REPORTED_LOOPS ? loops->loop_count : MAX_REPORTED_LOOPS;
+    for (int i = 0; i < reported; ++i) {
+        fprintf(file, " %.2f", loops->loop_area[i]);
+    }
+    fprintf(file, "   Valódi terület: %.2f pixel^2\n", loops->true_area);
     fclose(file);
 }
@@ -1,10 +1,14 @@
 #pragma once
 #include <stdbool.h>
 #include "types.h"
+#include "loops.h"
+#include "area.h"
 #include <stddef.h>  // size_t
 #include <stdio.h>
 
 
 void get_timestamp(char* buffer, size_t size);
 bool points_changed(Point old_points[], Point new_points[]);
-void save_area_to_file(double area, double error);
+void save_area_to_file(double area, double error, const Moments* moments);
+void save_loops_to_file(const LoopAreas* loops);
+double random_range(unsigned* state, double lo, double hi);
@@ -0,0 +1,798 @@
+#include "verify.h"
+#include "arena.h"
+#include "area.h"
+#include "bezier.h"
+#include "bezier_degree.h"
+#include "conic.h"
+#include "intersect.h"
+#include "loops.h"
+#include "offset.h"
+#include "pipeline.h"
+#include "power_basis.h"
+#include "query.h"
+#include "raster.h"
+#include "simplify.h"
+#include "stream.h"
+#include "utils.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Golden values. The polyline area of the default square at 100 steps is the one logged in
+// measurements.txt; the exact area follows from Green's theorem in rational arithmetic.
+#define DEFAULT_SQUARE_AREA_100 55984.00064
+#define DEFAULT_SQUARE_AREA 56000.0
+#define VERIFY_MAX_DEGREE 12
+#define VERIFY_DENSE_STEPS 4096
+#define VERIFY_PIPELINE_TIMEOUT_MS 5000
+#define CIRCLE_KAPPA 0.5522847498307936     // 4/3 (sqrt(2) - 1), cubic quarter circle handle
+
+typedef struct Verifier {
+    int checks;
+    int failures;
+    int group_checks;
+    int group_failures;
+    const char* group;
+} Verifier;
+
+static const Point DEFAULT_POINTS[N_POINTS] = { { 200, 200 }, { 400, 200 }, { 400, 400 }, { 200, 400 } };
+
+static void begin_group(Verifier* v, const char* name) {
+    v->group = name;
+    v->group_checks = 0;
+    v->group_failures = 0;
+}
+
+static void end_group(Verifier* v) {
+    printf("%-34s %4d ellenorzes  %s\n", v->group, v->group_checks, v->group_failures == 0 ? "OK" : "HIBA");
+}
+
+static void check_true(Verifier* v, const char* what, bool ok) {
+    ++v->checks;
+    ++v->group_checks;
+    if (!ok) {
+        ++v->failures;
+        ++v->group_failures;
+        printf("  HIBA %s: %s\n", v->group, what);
+    }
+}
+
+// Relative tolerance above magnitude 1, absolute below
+static void check_close(Verifier* v, const char* what, double value, double expected, double tolerance) {
+    ++v->checks;
+    ++v->group_checks;
+    if (!(fabs(value - expected) <= tolerance * fmax(1.0, fabs(expected)))) {
+        ++v->failures;
+        ++v->group_failures;
+        printf("  HIBA %s: %s = %.12g, elvart %.12g (tures %.1e)\n", v->group, what, value, expected, tolerance);
+    }
+}
+
+static void random_points(unsigned* state, Point points[], int count) {
+    for (int i = 0; i < count; ++i) {
+        points[i].x = random_range(state, 0.0, WINDOW_WIDTH);
+        points[i].y = random_range(state, 0.0, WINDOW_HEIGHT);
+    }
+}
+
+// Slow references: plain de Casteljau, and de Casteljau on homogeneous coordinates
+static Point de_casteljau_reference(const Point control[], int degree, double t) {
+    Point p[VERIFY_MAX_DEGREE + 1];
+    for (int i = 0; i <= degree; ++i) {
+        p[i] = control[i];
+    }
+    for (int k = 1; k <= degree; ++k) {
+        for (int i = 0; i <= degree - k; ++i) {
+            p[i].x = (1 - t) * p[i].x + t * p[i + 1].x;
+            p[i].y = (1 - t) * p[i].y + t * p[i + 1].y;
+        }
+    }
+    return p[0];
+}
+
+static Point rational_reference(const Point control[], const double weights[], int degree, double t) {
+    double x[VERIFY_MAX_DEGREE + 1], y[VERIFY_MAX_DEGREE + 1], w[VERIFY_MAX_DEGREE + 1];
+    for (int i = 0; i <= degree; ++i) {
+        x[i] = weights[i] * control[i].x;
+        y[i] = weights[i] * control[i].y;
+        w[i] = weights[i];
+    }
+    for (int k = 1; k <= degree; ++k) {
+        for (int i = 0; i <= degree - k; ++i) {
+            x[i] = (1 - t) * x[i] + t * x[i + 1];
+            y[i] = (1 - t) * y[i] + t * y[i + 1];
+            w[i] = (1 - t) * w[i] + t * w[i + 1];
+        }
+    }
+    Point p = { x[0] / w[0], y[0] / w[0] };
+    return p;
+}
+
+static double shoelace(const Point polyline[], int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        Point a = polyline[i], b = polyline[(i + 1) % count];
+        sum += a.x * b.y - b.x * a.y;
+    }
+    return sum / 2.0;
+}
+
+static int polyline_winding(const Point polyline[], int count, Point q) {
+    int winding = 0;
+    for (int i = 0; i < count; ++i) {
+        Point a = polyline[i], b = polyline[(i + 1) % count];
+        if ((a.y <= q.y) != (b.y <= q.y)) {
+            double x = a.x + (q.y - a.y) * (b.x - a.x) / (b.y - a.y);
+            if (x > q.x) {
+                winding += b.y > a.y ? 1 : -1;
+            }
+        }
+    }
+    return winding;
+}
+
+static Segment line_segment(Point a, Point b) {
+    Segment s = { { a, { a.x + (b.x - a.x) / 3.0, a.y + (b.y - a.y) / 3.0 },
+                    { a.x + (b.x - a.x) * 2.0 / 3.0, a.y + (b.y - a.y) * 2.0 / 3.0 }, b } };
+    return s;
+}
+
+// Counterclockwise cubic circle from four quarter arcs
+static void cubic_circle(Point center, double radius, Segment out[4]) {
+    for (int i = 0; i < 4; ++i) {
+        double a0 = i * 0.5 * M_PI, a1 = a0 + 0.5 * M_PI;
+        Point u0 = { cos(a0), sin(a0) }, u1 = { cos(a1), sin(a1) };
+        out[i].p[0] = (Point){ center.x + radius * u0.x, center.y + radius * u0.y };
+        out[i].p[1] = (Point){ out[i].p[0].x - CIRCLE_KAPPA * radius * u0.y, out[i].p[0].y + CIRCLE_KAPPA * radius * u0.x };
+        out[i].p[3] = (Point){ center.x + radius * u1.x, center.y + radius * u1.y };
+        out[i].p[2] = (Point){ out[i].p[3].x + CIRCLE_KAPPA * radius * u1.y, out[i].p[3].y - CIRCLE_KAPPA * radius * u1.x };
+    }
+}
+
+// .bzc record layout of a chain in which each segment starts where the previous one ends
+static void chain_to_record(const Segment chain[], int count, Point out[]) {
+    for (int i = 0; i < count; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            out[3 * i + k] = chain[i].p[k];
+        }
+    }
+}
+
+static void verify_golden_areas(Verifier* v) {
+    begin_group(v, "Arany teruletek");
+    Point points[N_POINTS];
+    memcpy(points, DEFAULT_POINTS, sizeof(points));
+    double error;
+    check_close(v, "calculate_area(alap negyzet, 100)", calculate_area(points, 100, &error), DEFAULT_SQUARE_AREA_100, 1e-10);
+    // The polyline misses the curve by a term proportional to 1/steps^2
+    check_close(v, "calculate_area(alap negyzet, 1000)", calculate_area(points, 1000, &error),
+                DEFAULT_SQUARE_AREA - (DEFAULT_SQUARE_AREA - DEFAULT_SQUARE_AREA_100) / 100.0, 1e-8);
+    Moments moments;
+    calculate_moments(points, &moments);
+    check_close(v, "calculate_moments terulet", moments.area, DEFAULT_SQUARE_AREA, 1e-12);
+    check_close(v, "sulypont x", moments.centroid.x, 300.0, 1e-12);
+    check_close(v, "sulypont y", moments.centroid.y, 300.0, 1e-12);
+
+    // Cubic arch closed by its chord: 3/5 of the unit square
+    Segment arch[1] = { { { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } } } };
+    segment_moments(arch, 1, &moments);
+    check_close(v, "iv a hur felett", moments.area, 0.6, 1e-14);
+
+    // Square of straight cubics
+    Point corners[4] = { { 100, 100 }, { 300, 100 }, { 300, 300 }, { 100, 300 } };
+    Segment square[4];
+    Point record[12];
+    for (int i = 0; i < 4; ++i) {
+        square[i] = line_segment(corners[i], corners[(i + 1) % 4]);
+    }
+    chain_to_record(square, 4, record);
+    segment_moments(square, 4, &moments);
+    check_close(v, "negyzet (segment_moments)", moments.area, 40000.0, 1e-14);
+    check_close(v, "negyzet (closed_curve_area)", closed_curve_area(record, 4), 40000.0, 1e-14);
+    check_close(v, "negyzet kerulete", closed_curve_length(record, 4), 800.0, 1e-12);
+
+    // Cubic circle: area (10 + 12k - 3k^2) r^2 / 5 in closed form; the exact conic gives pi r^2
+    Segment circle[4];
+    Point center = { 400, 300 };
+    double r = 150.0;
+    cubic_circle(center, r, circle);
+    chain_to_record(circle, 4, record);
+    double cubic_area = (10.0 + 12.0 * CIRCLE_KAPPA - 3.0 * CIRCLE_KAPPA * CIRCLE_KAPPA) * r * r / 5.0;
+    segment_moments(circle, 4, &moments);
+    check_close(v, "kobos kor (segment_moments)", moments.area, cubic_area, 1e-13);
+    check_close(v, "kobos kor (closed_curve_area)", closed_curve_area(record, 4), cubic_area, 1e-13);
+    check_close(v, "kobos kor sulypont x", moments.centroid.x, center.x, 1e-12);
+    Conic arcs[CONIC_MAX_ARC_PIECES];
+    int count = conic_ellipse(center, r, r, 0.3, arcs);
+    check_close(v, "racionalis kor", conic_chain_area(arcs, count), M_PI * r * r, 1e-13);
+    count = conic_ellipse(center, 200, 80, 1.1, arcs);
+    check_close(v, "racionalis ellipszis", conic_chain_area(arcs, count), M_PI * 200 * 80, 1e-13);
+    check_close(v, "kor kerulete (AGM)", ellipse_perimeter(r, r), 2.0 * M_PI * r, 1e-14);
+    check_close(v, "kor negyedive (Carlson)", ellipse_arc_length(r, r, 0.2, 0.5 * M_PI), 0.5 * M_PI * r, 1e-13);
+    // An eccentric arc exercises every term of the R_D series; the quadrature is independent
+    count = conic_ellipse_arc(center, 200, 80, 0.0, 0.4, 4.0, arcs);
+    double quadrature = 0.0;
+    for (int i = 0; i < count; ++i) {
+        quadrature += conic_length(&arcs[i]);
+    }
+    check_close(v, "ellipszis ive (Carlson)", ellipse_arc_length(200, 80, 0.4, 4.0), quadrature, 1e-12);
+    // w < 0 traces the complementary arc: the two arcs over one chord bound the whole circle
+    double half = 1.0;
+    Conic minor_arc = conic_from_points((Point){ center.x + r * cos(half), center.y - r * sin(half) },
+                                        (Point){ center.x + r / cos(half), center.y },
+                                        (Point){ center.x + r * cos(half), center.y + r * sin(half) }, cos(half));
+    Conic major_arc = minor_arc;
+    major_arc.w = -minor_arc.w;
+    check_close(v, "kor kiegeszito ivvel (w < 0)", fabs(conic_green(&minor_arc) - conic_green(&major_arc)),
+                M_PI * r * r, 1e-13);
+    end_group(v);
+}
+
+static void verify_evaluators(Verifier* v) {
+    begin_group(v, "Kiertekelok vs de Casteljau");
+    unsigned state = 12345u;
+    double t[33];
+    Point batch[33];
+    for (int k = 0; k <= 32; ++k) {
+        t[k] = k / 32.0;
+    }
+    for (int degree = 1; degree <= VERIFY_MAX_DEGREE; ++degree) {
+        Point control[VERIFY_MAX_DEGREE + 1];
+        double weights[VERIFY_MAX_DEGREE + 1];
+        random_points(&state, control, degree + 1);
+        for (int i = 0; i <= degree; ++i) {
+            weights[i] = random_range(&state, 0.2, 5.0);
+        }
+        double worst = 0.0, worst_runtime = 0.0, worst_batch = 0.0, worst_rational = 0.0, worst_rational_batch = 0.0;
+        bezier_eval_batch(control, degree, t, 33, batch);
+        for (int k = 0; k <= 32; ++k) {
+            Point expected = de_casteljau_reference(control, degree, t[k]);
+            Point p = bezier_eval(control, degree, t[k]);
+            Point q = bezier_eval_runtime(control, degree, t[k]);
+            worst = fmax(worst, hypot(p.x - expected.x, p.y - expected.y));
+            worst_runtime = fmax(worst_runtime, hypot(q.x - expected.x, q.y - expected.y));
+            worst_batch = fmax(worst_batch, hypot(batch[k].x - expected.x, batch[k].y - expected.y));
+            Point rational = rational_reference(control, weights, degree, t[k]);
+            Point fast = rational_bezier_eval(control, weights, degree, t[k]);
+            worst_rational = fmax(worst_rational, hypot(fast.x - rational.x, fast.y - rational.y));
+        }
+        rational_bezier_eval_batch(control, weights, degree, t, 33, batch);
+        for (int k = 0; k <= 32; ++k) {
+            Point rational = rational_reference(control, weights, degree, t[k]);
+            worst_rational_batch = fmax(worst_rational_batch, hypot(batch[k].x - rational.x, batch[k].y - rational.y));
+        }
+        check_close(v, "bezier_eval", worst, 0.0, 1e-9);
+        check_close(v, "bezier_eval_runtime", worst_runtime, 0.0, 1e-9);
+        check_close(v, "bezier_eval_batch", worst_batch, 0.0, 1e-9);
+        check_close(v, "rational_bezier_eval", worst_rational, 0.0, 1e-9);
+        check_close(v, "rational_bezier_eval_batch", worst_rational_batch, 0.0, 1e-9);
+    }
+
+    // The cubic behind calculate_area() and the float path
+    double worst = 0.0, worst_f = 0.0;
+    for (int c = 0; c < 100; ++c) {
+        Point control[4];
+        random_points(&state, control, 4);
+        for (int k = 0; k <= 32; ++k) {
+            Point expected = de_casteljau_reference(control, 3, t[k]);
+            Point p = bezier(control[0], control[1], control[2], control[3], t[k]);
+            PowerCubicF cubic = power_cubic_f(control);
+            PointF f = power_cubic_f_eval(&cubic, (float)t[k]);
+            worst = fmax(worst, hypot(p.x - expected.x, p.y - expected.y));
+            worst_f = fmax(worst_f, hypot(f.x - expected.x, f.y - expected.y));
+        }
+    }
+    check_close(v, "bezier", worst, 0.0, 1e-10);
+    check_close(v, "power_cubic_f_eval", worst_f, 0.0, 1e-3);
+
+    // Splitting reproduces the same curve on both halves
+    Segment s = { { DEFAULT_POINTS[0], DEFAULT_POINTS[1], DEFAULT_POINTS[2], DEFAULT_POINTS[3] } }, left, right;
+    split_segment(&s, 0.3, &left, &right);
+    Point a = bezier(left.p[0], left.p[1], left.p[2], left.p[3], 0.5);
+    Point b = bezier(s.p[0], s.p[1], s.p[2], s.p[3], 0.15);
+    check_close(v, "split_segment", hypot(a.x - b.x, a.y - b.y), 0.0, 1e-12);
+    Segment middle = sub_segment(&s, 0.2, 0.7);
+    a = bezier(middle.p[0], middle.p[1], middle.p[2], middle.p[3], 0.5);
+    b = bezier(s.p[0], s.p[1], s.p[2], s.p[3], 0.45);
+    check_close(v, "sub_segment", hypot(a.x - b.x, a.y - b.y), 0.0, 1e-12);
+    end_group(v);
+}
+
+static void wavy_chain(Segment segments[], int count, Point center, double radius, double amplitude, int waves) {
+    double h = 2.0 * M_PI / count;
+    for (int i = 0; i < count; ++i) {
+        for (int k = 0; k < 2; ++k) {
+            double theta = (i + k) * h;
+            double r = radius + amplitude * sin(waves * theta);
+            double dr = amplitude * waves * cos(waves * theta);
+            Point p = { center.x + r * cos(theta), center.y + r * sin(theta) };
+            Point d = { dr * cos(theta) - r * sin(theta), dr * sin(theta) + r * cos(theta) };
+            segments[i].p[3 * k] = p;
+            segments[i].p[1 + k] = (Point){ p.x + (k == 0 ? 1 : -1) * d.x * h / 3.0, p.y + (k == 0 ? 1 : -1) * d.y * h / 3.0 };
+        }
+    }
+}
+
+static void verify_power_basis(Verifier* v) {
+    begin_group(v, "Hatvanybazis vs Bernstein");
+    enum { SEGMENTS = 64, STEPS = 32 };
+    static Segment segments[SEGMENTS];
+    static Point bernstein[SEGMENTS * (STEPS + 1)], horner[SEGMENTS * (STEPS + 1)];
+    wavy_chain(segments, SEGMENTS, (Point){ 400, 300 }, 200, 20, 5);
+    PowerBasis basis = { 0 };
+    check_true(v, "power_basis_update", power_basis_update(&basis, segments, SEGMENTS));
+    tessellate_segments(segments, SEGMENTS, STEPS, bernstein);
+    power_basis_tessellate(&basis, STEPS, horner);
+    double worst = 0.0, worst_tangent = 0.0;
+    for (int i = 0; i < SEGMENTS * (STEPS + 1); ++i) {
+        worst = fmax(worst, hypot(horner[i].x - bernstein[i].x, horner[i].y - bernstein[i].y));
+    }
+    const double h = 1e-6;
+    for (int i = 0; i < SEGMENTS; ++i) {
+        Point* p = segments[i].p;
+        for (int k = 1; k < STEPS; ++k) {
+            double t = (double)k / STEPS;
+            Point d = power_basis_tangent(&basis, i, t);
+            Point ahead = bezier(p[0], p[1], p[2], p[3], t + h), behind = bezier(p[0], p[1], p[2], p[3], t - h);
+            worst_tangent = fmax(worst_tangent, hypot(d.x - (ahead.x - behind.x) / (2 * h), d.y - (ahead.y - behind.y) / (2 * h)));
+        }
+    }
+    // The batch pass gives the same numbers as the single queries
+    static CurveSample field[SEGMENTS * (STEPS + 1)];
+    power_basis_sample_chain(&basis, STEPS, field);
+    double worst_field = 0.0;
+    for (int i = 0; i < SEGMENTS; ++i) {
+        for (int k = 0; k <= STEPS; ++k) {
+            const CurveSample* s = &field[i * (STEPS + 1) + k];
+            double t = (double)k / STEPS;
+            Point p = power_basis_eval(&basis, i, t), d = power_basis_tangent(&basis, i, t);
+            worst_field = fmax(worst_field, hypot(s->position.x - p.x, s->position.y - p.y) +
+                                            hypot(s->d1.x - d.x, s->d1.y - d.y) +
+                                            fabs(s->curvature - power_basis_curvature(&basis, i, t)));
+        }
+    }
+    check_close(v, "egy menetes mintavetel", worst_field, 0.0, 1e-12);
+    check_close(v, "kiertekeles", worst, 0.0, 1e-10);
+    check_close(v, "erinto (kozepponti differencia)", worst_tangent, 0.0, 1e-4);
+
+    // At an arc end of the kappa circle the curvature is (2/3) h / |p1 - p0|^2 with
+    // h = r (1 - k) the distance of p2 from the end tangent; in between, against differences
+    Segment circle[4];
+    cubic_circle((Point){ 400, 300 }, 150, circle);
+    check_true(v, "kor frissitese", power_basis_update(&basis, circle, 4));
+    double end_curvature = 2.0 / 3.0 * (1.0 - CIRCLE_KAPPA) / (CIRCLE_KAPPA * CIRCLE_KAPPA * 150);
+    check_close(v, "gorbulet az iv vegen", power_basis_curvature(&basis, 1, 0.0), end_curvature, 1e-12);
+    double worst_curvature = 0.0;
+    for (int k = 1; k < STEPS; ++k) {
+        double t = (double)k / STEPS;
+        Point* p = circle[1].p;
+        Point ahead = bezier(p[0], p[1], p[2], p[3], t + 1e-4), here = bezier(p[0], p[1], p[2], p[3], t);
+        Point behind = bezier(p[0], p[1], p[2], p[3], t - 1e-4);
+        Point d1 = { (ahead.x - behind.x) / 2e-4, (ahead.y - behind.y) / 2e-4 };
+        Point d2 = { (ahead.x - 2 * here.x + behind.x) / 1e-8, (ahead.y - 2 * here.y + behind.y) / 1e-8 };
+        double curvature = (d1.x * d2.y - d1.y * d2.x) / pow(hypot(d1.x, d1.y), 3);
+        worst_curvature = fmax(worst_curvature, fabs(power_basis_curvature(&basis, 1, t) - curvature) * 150);
+    }
+    check_close(v, "gorbulet (differenciak)", worst_curvature, 0.0, 1e-4);
+    Moments moments;
+    segment_moments(circle, 4, &moments);
+    check_close(v, "terulet vs segment_moments", power_basis_area(&basis), moments.area, 1e-13);
+
+    // Unchanged segments are not converted again
+    long conversions = basis.conversions;
+    power_basis_update(&basis, circle, 4);
+    check_true(v, "valtozatlan gorbe", basis.conversions == conversions);
+    circle[2].p[1].x += 1.0;
+    power_basis_update(&basis, circle, 4);
+    check_true(v, "egy szegmens valtozott", basis.conversions == conversions + 1);
+    check_true(v, "igazitas", (uintptr_t)basis.ax % POWER_BASIS_ALIGNMENT == 0 &&
+                              (uintptr_t)basis.dby % POWER_BASIS_ALIGNMENT == 0);
+    power_basis_free(&basis);
+    end_group(v);
+}
+
+static void verify_areas(Verifier* v) {
+    begin_group(v, "Terulet: gyors vs referencia");
+    unsigned state = 777u;
+    for (int c = 0; c < 50; ++c) {
+        Point points[N_POINTS];
+        random_points(&state, points, N_POINTS);
+        Segment segments[N_POINTS];
+        build_segments(points, N_POINTS, segments);
+        Moments moments;
+        segment_moments(segments, N_POINTS, &moments);
+        double error, error_f;
+        double dense = calculate_area(points, VERIFY_DENSE_STEPS, &error);
+        check_close(v, "calculate_area suru vs Green", dense, moments.area, 1e-5);
+        double area = calculate_area(points, 100, &error);
+        double area_f = calculate_area_precision(points, 100, PRECISION_FLOAT, &error_f);
+        check_close(v, "float vs double terulet", area_f, area, 1e-4);
+
+        // Stream layout of the same closed curve, walked in outline order
+        Segment chain[N_POINTS];
+        Point record[3 * N_POINTS];
+        for (int k = 0; k < N_POINTS; ++k) {
+            chain[k] = segments[(N_POINTS - k) % N_POINTS];
+        }
+        chain_to_record(chain, N_POINTS, record);
+        check_close(v, "closed_curve_area vs segment_moments", closed_curve_area(record, N_POINTS), moments.area, 1e-10);
+
+        // Moments against the dense outline polygon
+        static Point outline[N_POINTS * VERIFY_DENSE_STEPS];
+        tessellate_outline(segments, N_POINTS, VERIFY_DENSE_STEPS, outline);
+        int count = N_POINTS * VERIFY_DENSE_STEPS;
+        double twice = 0.0, cx = 0.0, cy = 0.0;
+        for (int i = 0; i < count; ++i) {
+            Point p = outline[i], q = outline[(i + 1) % count];
+            double cross = p.x * q.y - q.x * p.y;
+            twice += cross;
+            cx += (p.x + q.x) * cross;
+            cy += (p.y + q.y) * cross;
+        }
+        if (fabs(twice) > 1000.0) {
+            check_close(v, "sulypont x vs sokszog", moments.centroid.x, cx / (3.0 * twice), 1e-4);
+            check_close(v, "sulypont y vs sokszog", moments.centroid.y, cy / (3.0 * twice), 1e-4);
+        }
+        check_close(v, "tessellate_outline vs Green", fabs(shoelace(outline, count)), moments.area, 1e-5);
+
+        // Loop decomposition keeps the signed total
+        LoopAreas loops;
+        if (decompose_loops(outline, count, &loops)) {
+            check_close(v, "hurkok elojeles osszege", fabs(loops.signed_area), fabs(shoelace(outline, count)), 1e-9);
+            if (loops.crossing_count == 0) {
+                check_close(v, "valodi terulet onmetszes nelkul", loops.true_area, fabs(loops.signed_area), 1e-9);
+            }
+        } else {
+            check_true(v, "decompose_loops", false);
+        }
+    }
+
+    // Limacon r = R (1 + 2 cos theta): the inner loop turns the same way as the outer one
+    // and lies inside it. The true area is the outer loop alone, (2 pi + 3 sqrt(3) / 2) R^2,
+    // while the signed total counts the inner loop twice, 3 pi R^2.
+    enum { LIMACON_SAMPLES = 4000 };
+    static Point limacon[LIMACON_SAMPLES];
+    double R = 100.0;
+    for (int i = 0; i < LIMACON_SAMPLES; ++i) {
+        double theta = 2.0 * M_PI * i / LIMACON_SAMPLES;
+        double r = R * (1.0 + 2.0 * cos(theta));
+        limacon[i] = (Point){ 400.0 + r * cos(theta), 300.0 + r * sin(theta) };
+    }
+    LoopAreas loops;
+    if (decompose_loops(limacon, LIMACON_SAMPLES, &loops)) {
+        check_true(v, "limacon metszespontja", loops.crossing_count == 1 && loops.loop_count == 2);
+        check_close(v, "limacon elojeles terulete", fabs(loops.signed_area), 3.0 * M_PI * R * R, 1e-5);
+        check_close(v, "limacon valodi terulete", loops.true_area, (2.0 * M_PI + 1.5 * sqrt(3.0)) * R * R, 1e-5);
+    } else {
+        check_true(v, "decompose_loops", false);
+    }
+    end_group(v);
+}
+
+static void verify_pipeline(Verifier* v) {
+    begin_group(v, "Munkaszalas szamolas");
+    Point points[N_POINTS];
+    memcpy(points, DEFAULT_POINTS, sizeof(points));
+    if (!pipeline_start(100)) {
+        check_true(v, "pipeline_start", false);
+        end_group(v);
+        return;
+    }
+    pipeline_submit(points);
+    const Geometry* geometry = NULL;
+    Uint32 start = SDL_GetTicks();
+    while ((geometry = pipeline_latest()) == NULL && SDL_GetTicks() - start < VERIFY_PIPELINE_TIMEOUT_MS) {
+        SDL_Delay(1);
+    }
+    check_true(v, "eredmeny idoben", geometry != NULL);
+    if (geometry != NULL) {
+        double error;
+        check_close(v, "terulet", geometry->area, calculate_area(points, 100, &error), 1e-10);
+        check_close(v, "arany terulet", geometry->area, DEFAULT_SQUARE_AREA_100, 1e-10);
+    }
+    pipeline_stop();
+    end_group(v);
+}
+
+static void verify_intersections(Verifier* v) {
+    begin_group(v, "Metszes: sweep vs brute force");
+    enum { SEGMENTS = 300, MAX_HITS = 1024 };
+    static Segment a[SEGMENTS], b[SEGMENTS];
+    static Intersection fast[MAX_HITS], slow[MAX_HITS];
+    wavy_chain(a, SEGMENTS, (Point){ 380, 300 }, 200, 12, 37);
+    wavy_chain(b, SEGMENTS, (Point){ 420, 290 }, 200, 12, 40);
+    int found = intersect_curves(a, SEGMENTS, b, SEGMENTS, fast, MAX_HITS);
+    int reference = intersect_curves_brute_force(a, SEGMENTS, b, SEGMENTS, slow, MAX_HITS);
+    check_true(v, "metszespontok szama", found == reference && found > 0);
+    double worst = 0.0;
+    for (int i = 0; i < found; ++i) {
+        double best = INFINITY;
+        for (int k = 0; k < reference; ++k) {
+            best = fmin(best, hypot(fast[i].point.x - slow[k].point.x, fast[i].point.y - slow[k].point.y));
+        }
+        worst = fmax(worst, best);
+        Segment* sa = &a[fast[i].segment_a];
+        Point on_a = bezier(sa->p[0], sa->p[1], sa->p[2], sa->p[3], fast[i].t_a);
+        worst = fmax(worst, hypot(on_a.x - fast[i].point.x, on_a.y - fast[i].point.y));
+    }
+    check_close(v, "metszespontok helye", worst, 0.0, 1e-6);
+
+    // Perpendicular straight cubics: once one is clipped down to a point, the other must
+    // still be clipped across, in either order
+    Segment vertical = line_segment((Point){ 492, 208 }, (Point){ 492, 400 });
+    Segment horizontal = line_segment((Point){ 500, 392 }, (Point){ 308, 392 });
+    Intersection hits[2];
+    bool both = intersect_curves(&vertical, 1, &horizontal, 1, &hits[0], 1) == 1 &&
+                intersect_curves(&horizontal, 1, &vertical, 1, &hits[1], 1) == 1;
+    check_true(v, "meroleges szakaszok", both && hypot(hits[0].point.x - 492, hits[0].point.y - 392) < 1e-6 &&
+                                         hypot(hits[1].point.x - 492, hits[1].point.y - 392) < 1e-6);
+
+    // The outline of the control points, in build_segments() order and as a chain in which
+    // each segment starts where the previous ends: the same crossings, none at a joint
+    Segment segments[N_POINTS], chain[N_POINTS];
+    build_segments(DEFAULT_POINTS, N_POINTS, segments);
+    for (int k = 0; k < N_POINTS; ++k) {
+        chain[k] = segments[(N_POINTS - k) % N_POINTS];
+    }
+    int forward = intersect_self(segments, N_POINTS, fast, MAX_HITS);
+    int backward = intersect_self(chain, N_POINTS, slow, MAX_HITS);
+    check_true(v, "intersect_self mindket iranyban", forward == backward && forward > 0);
+    double nearest_joint = INFINITY;
+    for (int i = 0; i < forward + backward; ++i) {
+        Point hit = i < forward ? fast[i].point : slow[i - forward].point;
+        for (int k = 0; k < N_POINTS; ++k) {
+            nearest_joint = fmin(nearest_joint, hypot(hit.x - DEFAULT_POINTS[k].x, hit.y - DEFAULT_POINTS[k].y));
+        }
+    }
+    check_true(v, "intersect_self csatlakozasok nelkul", nearest_joint > 1.0);
+
+    // A loop inside one cubic, closed by a line: a single crossing of segment 0 with itself,
+    // symmetric in t because the control polygon is
+    Segment looped[2] = {
+        { { { 100, 100 }, { 400, 400 }, { 0, 400 }, { 300, 100 } } },
+        line_segment((Point){ 300, 100 }, (Point){ 100, 100 })
+    };
+    int loops = intersect_self(looped, 2, fast, MAX_HITS);
+    bool on_loop = loops == 1 && fast[0].segment_a == 0 && fast[0].segment_b == 0 && fast[0].t_a < fast[0].t_b;
+    if (on_loop) {
+        const Point* p = looped[0].p;
+        Point first = bezier(p[0], p[1], p[2], p[3], fast[0].t_a);
+        Point second = bezier(p[0], p[1], p[2], p[3], fast[0].t_b);
+        on_loop = hypot(first.x - second.x, first.y - second.y) < 1e-6 && fabs(fast[0].t_a + fast[0].t_b - 1.0) < 1e-6;
+    }
+    check_true(v, "hurok egy szegmensen belul", on_loop);
+    end_group(v);
+}
+
+static void verify_queries(Verifier* v) {
+    begin_group(v, "Lekerdezes vs suru mintavetel");
+    enum { SEGMENTS = 200, QUERIES = 400 };
+    static Segment segments[SEGMENTS];
+    static Point polyline[SEGMENTS * 64];
+    wavy_chain(segments, SEGMENTS, (Point){ 400, 300 }, 220, 30, 9);
+    for (int i = 0; i < SEGMENTS; ++i) {
+        for (int k = 0; k < 64; ++k) {
+            Point* p = segments[i].p;
+            polyline[i * 64 + k] = bezier(p[0], p[1], p[2], p[3], k / 64.0);
+        }
+    }
+    CurveQuery query;
+    if (!query_build(&query, segments, SEGMENTS)) {
+        check_true(v, "query_build", false);
+        end_group(v);
+        return;
+    }
+    unsigned state = 4242u;
+    static Point q[QUERIES];
+    static int windings[QUERIES];
+    static NearestPoint nearest[QUERIES];
+    random_points(&state, q, QUERIES);
+    query_winding_batch(&query, q, QUERIES, windings);
+    query_nearest_batch(&query, q, QUERIES, nearest);
+    int winding_mismatch = 0, batch_mismatch = 0;
+    double worst_distance = 0.0;
+    for (int i = 0; i < QUERIES; ++i) {
+        NearestPoint single = query_nearest(&query, q[i]);
+        double sampled = INFINITY;
+        for (int k = 0; k < SEGMENTS * 64; ++k) {
+            sampled = fmin(sampled, hypot(polyline[k].x - q[i].x, polyline[k].y - q[i].y));
+        }
+        // Exact nearest can only be closer than the samples, and not by more than their spacing
+        worst_distance = fmax(worst_distance, single.distance - sampled);
+        check_true(v, "legkozelebbi pont nem tavolabb", single.distance <= sampled + 1e-9 && sampled - single.distance < 1.0);
+        if (nearest[i].distance != single.distance || windings[i] != query_winding(&query, q[i])) {
+            ++batch_mismatch;
+        }
+        if (single.distance > 1.0 && windings[i] != polyline_winding(polyline, SEGMENTS * 64, q[i])) {
+            ++winding_mismatch;
+        }
+    }
+    check_true(v, "korulfordulasi szam", winding_mismatch == 0);
+    check_true(v, "batch = egyenkenti", batch_mismatch == 0);
+    query_free(&query);
+    end_group(v);
+}
+
+static void verify_raster(Verifier* v) {
+    begin_group(v, "Raszter kitoltes");
+    Raster raster;
+    if (!raster_init(&raster, 256, 256)) {
+        check_true(v, "raster_init", false);
+        end_group(v);
+        return;
+    }
+    raster_clear(&raster, 0);
+    Point rectangle[4] = { { 10.5, 10.5 }, { 110.5, 10.5 }, { 110.5, 60.5 }, { 10.5, 60.5 } };
+    long winding_area;
+    check_true(v, "teglalap pixelszam", fill_polygon_nonzero(&raster, rectangle, 4, 1, &winding_area) == 5000);
+    check_true(v, "teglalap korulfordulasi osszeg", labs(winding_area) == 5000);
+    // Doubly wound square: the same pixels, twice the winding sum
+    Point twice[8];
+    for (int i = 0; i < 8; ++i) {
+        twice[i] = rectangle[i % 4];
+    }
+    check_true(v, "ketszer korbejart teglalap", fill_polygon_nonzero(&raster, twice, 8, 1, &winding_area) == 5000 &&
+                                                labs(winding_area) == 10000);
+    PointF rectangle_f[4];
+    for (int i = 0; i < 4; ++i) {
+        rectangle_f[i] = (PointF){ (float)rectangle[i].x, (float)rectangle[i].y };
+    }
+    check_true(v, "float teglalap", fill_polygon_nonzero_f(&raster, rectangle_f, 4, 1, NULL) == 5000);
+    raster_free(&raster);
+    end_group(v);
+}
+
+static void verify_fitting(Verifier* v) {
+    begin_group(v, "Egyszerusites es offset");
+    enum { SEGMENTS = 200, STEPS = 16 };
+    static Segment segments[SEGMENTS];
+    static Point polyline[SEGMENTS * STEPS], fitted[3 * SEGMENTS * STEPS + 1], record[3 * SEGMENTS];
+    wavy_chain(segments, SEGMENTS, (Point){ 400, 300 }, 220, 25, 7);
+    for (int i = 0; i < SEGMENTS; ++i) {
+        for (int k = 0; k < STEPS; ++k) {
+            Point* p = segments[i].p;
+            polyline[i * STEPS + k] = bezier(p[0], p[1], p[2], p[3], (double)k / STEPS);
+        }
+    }
+    chain_to_record(segments, SEGMENTS, record);
+    double area = closed_curve_area(record, SEGMENTS);
+    double error;
+    int count = fit_closed_polyline(polyline, SEGMENTS * STEPS, 0.25, fitted, SEGMENTS * STEPS, &error);
+    check_true(v, "illesztes kevesebb szegmenssel", count > 0 && count < SEGMENTS);
+    check_true(v, "illesztesi hiba a tureson belul", error <= 0.25);
+    if (count > 0) {
+        check_close(v, "illesztett terulet", closed_curve_area(fitted, count), area, 1e-3);
+    }
+
+    unsigned state = 99u;
+    double worst = 0.0;
+    for (int c = 0; c < 20; ++c) {
+        Point control[VERIFY_MAX_DEGREE + 1];
+        random_points(&state, control, VERIFY_MAX_DEGREE + 1);
+        count = reduce_degree(control, VERIFY_MAX_DEGREE, 0.5, fitted, SEGMENTS * STEPS, &error);
+        worst = fmax(worst, error);
+        check_true(v, "fokszamcsokkentes vegpontjai", count > 0 && fitted[0].x == control[0].x &&
+                                                      fitted[3 * count].y == control[VERIFY_MAX_DEGREE].y);
+    }
+    check_true(v, "fokszamcsokkentes hibaja", worst <= 0.5);
+    // Every control point in one place: a single collapsed cubic instead of NaN parameters.
+    // At the origin the samples coincide exactly, elsewhere only up to rounding.
+    Point places[2] = { { 0, 0 }, { 250, 150 } };
+    for (int c = 0; c < 2; ++c) {
+        Point same[VERIFY_MAX_DEGREE + 1];
+        for (int k = 0; k <= VERIFY_MAX_DEGREE; ++k) {
+            same[k] = places[c];
+        }
+        count = reduce_degree(same, VERIFY_MAX_DEGREE, 0.5, fitted, SEGMENTS * STEPS, &error);
+        bool collapsed = count == 1 && error <= 1e-9;
+        for (int k = 0; k < 4 && collapsed; ++k) {
+            collapsed = hypot(fitted[k].x - places[c].x, fitted[k].y - places[c].y) <= 1e-9;
+        }
+        check_true(v, "fokszamcsokkentes egy pontra", collapsed);
+    }
+
+    // Band around a circle: 2 d L by Steiner's formula, no joins on a smooth curve
+    Segment circle[4];
+    Point circle_record[12];
+    cubic_circle((Point){ 400, 300 }, 150, circle);
+    chain_to_record(circle, 4, circle_record);
+    double length = closed_curve_length(circle_record, 4);
+    Stroke stroke = { 0 };
+    if (stroke_build(&stroke, circle, 4, 8.0, JOIN_ROUND, 0.01)) {
+        check_close(v, "kor savjanak terulete", stroke.band_area, 2.0 * 8.0 * length, 1e-4);
+    } else {
+        check_true(v, "stroke_build", false);
+    }
+
+    // Corners: the outer side gains a round sector of d^2 theta / 2 and the inner side loses
+    // the kite of d^2 tan(theta / 2) cut off by the trim
+    Point corners[4] = { { 300, 200 }, { 500, 200 }, { 500, 400 }, { 300, 400 } };
+    Segment square[4];
+    for (int i = 0; i < 4; ++i) {
+        square[i] = line_segment(corners[i], corners[(i + 1) % 4]);
+    }
+    double corner_term = 4.0 * (0.25 * M_PI - 1.0) * 8.0 * 8.0;
+    if (stroke_build(&stroke, square, 4, 8.0, JOIN_ROUND, 0.01)) {
+        check_close(v, "negyzet savja (kerek)", stroke.band_area, 2.0 * 8.0 * 800.0 + corner_term, 1e-5);
+    } else {
+        check_true(v, "stroke_build", false);
+    }
+    if (stroke_build(&stroke, square, 4, 8.0, JOIN_MITER, 0.01)) {
+        check_close(v, "negyzet savja (miter)", stroke.band_area, 2.0 * 8.0 * 800.0, 1e-12);
+    } else {
+        check_true(v, "stroke_build", false);
+    }
+
+    // Figure-eight of the control points: its lobes turn opposite ways, and the band
+    // covers both of them instead of cancelling. The corners are curved, so the corner
+    // terms above hold only up to O(d^3).
+    Point eight[N_POINTS] = { { 200, 200 }, { 600, 400 }, { 600, 200 }, { 200, 400 } };
+    Segment eight_segments[N_POINTS], eight_chain[N_POINTS];
+    Point eight_record[3 * N_POINTS];
+    build_segments(eight, N_POINTS, eight_segments);
+    for (int k = 0; k < N_POINTS; ++k) {
+        eight_chain[k] = eight_segments[(N_POINTS - k) % N_POINTS];
+    }
+    chain_to_record(eight_chain, N_POINTS, eight_record);
+    double expected = 2.0 * 8.0 * closed_curve_length(eight_record, N_POINTS);
+    for (int k = 0; k < N_POINTS; ++k) {
+        const Point* in = eight_chain[k].p;
+        const Point* out = eight_chain[(k + 1) % N_POINTS].p;
+        Point t_in = { in[3].x - in[2].x, in[3].y - in[2].y }, t_out = { out[1].x - out[0].x, out[1].y - out[0].y };
+        double theta = fabs(atan2(t_in.x * t_out.y - t_in.y * t_out.x, t_in.x * t_out.x + t_in.y * t_out.y));
+        expected += (0.5 * theta - tan(0.5 * theta)) * 8.0 * 8.0;
+    }
+    if (stroke_update(&stroke, eight, 8.0, JOIN_ROUND, 0.01)) {
+        check_close(v, "nyolcas savja", stroke.band_area, expected, 1e-3);
+    } else {
+        check_true(v, "stroke_update", false);
+    }
+    stroke_free(&stroke);
+    end_group(v);
+}
+
+static void verify_arena(Verifier* v) {
+    begin_group(v, "Arena");
+    Arena arena;
+    if (!arena_init(&arena, 256)) {
+        check_true(v, "arena_init", false);
+        end_group(v);
+        return;
+    }
+    void* a = arena_alloc(&arena, 3);
+    void* b = arena_alloc(&arena, 40);
+    check_true(v, "igazitas", ((uintptr_t)a % ARENA_ALIGNMENT) == 0 && ((uintptr_t)b % ARENA_ALIGNMENT) == 0);
+    check_true(v, "helyben novekszik", arena_realloc(&arena, b, 40, 80) == b);
+    size_t mark = arena_mark(&arena);
+    arena_alloc(&arena, 1000);
+    check_true(v, "tulcsordulas malloc-kal", arena.overflow_count == 1);
+    arena_release(&arena, mark);
+    check_true(v, "visszaallitas a jelig", arena_mark(&arena) == mark);
+    arena_reset(&arena);
+    check_true(v, "nullazas utan megno", arena.capacity >= arena.peak && arena_mark(&arena) == 0);
+    arena_free(&arena);
+    end_group(v);
+}
+
+// --verify: golden values and fast paths against slow references. Exits non-zero on any
+// failure, so it can gate performance work.
+int run_verification(void) {
+    Verifier v = { 0 };
+    verify_golden_areas(&v);
+    verify_evaluators(&v);
+    verify_power_basis(&v);
+    verify_areas(&v);
+    verify_pipeline(&v);
+    verify_intersections(&v);
+    verify_queries(&v);
+    verify_raster(&v);
+    verify_fitting(&v);
+    verify_arena(&v);
+    scratch_arena_shutdown();
+    printf("Osszesen: %d ellenorzes, %d hiba\n", v.checks, v.failures);
+    return v.failures == 0 ? 0 : 1;
+}
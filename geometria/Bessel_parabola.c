@@ -5,6 +5,9 @@
 
 const double POINT_RADIUS = 10.0;
 const int N_POINTS = 3;
+#define MAX_POINTS 64
+#define SAMPLES_PER_SEGMENT 32
+#define TANGENT_LENGTH 60.0
 
 /**
  * A simple point structure.
@@ -16,31 +19,108 @@ typedef struct Point
 } Point;
 
 /**
- * Kiszámítja a Bessel parabola középső pontjára tartozó érintőt.
+ * Bessel (Overhauser) spline: minden belső csomópont érintője a szomszédaira
+ * illesztett parabola deriváltja (húrhossz szerinti paraméterezés), a szegmensek
+ * köbös Hermite-ívek. A húrok és érintők koordinátánként külön tömbökben vannak,
+ * így az érintőszámítás egyetlen elágazásmentes, vektorizálható ciklus.
  */
-void bessel_tangent(Point points[], Point* tangent_point) {
-  double x1 = points[0].x, y1 = points[0].y;
-  double x2 = points[1].x, y2 = points[1].y;
-  double x3 = points[2].x, y3 = points[2].y;
-
-  // Kiszámítjuk a parabola érintőjét a középső pontra
-  tangent_point->x = x2;
-  tangent_point->y = (y1 + y3) / 2.0;  // Egyszerűsített érintő számítás
+typedef struct BesselSpline
+{
+  int n;
+  double h[MAX_POINTS];                 // húrhossz: |P_(i+1) - P_i|
+  double dx[MAX_POINTS], dy[MAX_POINTS]; // húr irány: (P_(i+1) - P_i) / h_i
+  double tx[MAX_POINTS], ty[MAX_POINTS]; // érintő, ívhossz-paraméter szerint
+} BesselSpline;
+
+/**
+ * Az i. húr (P_i -> P_(i+1)) frissítése. Egybeeső pontoknál a húr iránya nulla.
+ */
+void bessel_chord(BesselSpline* spline, Point points[], int i) {
+  double ex = points[i + 1].x - points[i].x;
+  double ey = points[i + 1].y - points[i].y;
+  double length = sqrt(ex * ex + ey * ey);
+  double inv = length > 1e-9 ? 1.0 / length : 0.0;
+  spline->h[i] = length > 1e-9 ? length : 1e-9;
+  spline->dx[i] = ex * inv;
+  spline->dy[i] = ey * inv;
+}
+
+/**
+ * A középső pont érintője a prev, mid, next pontokon átmenő parabolából:
+ * m = (h_1 d_0 + h_0 d_1) / (h_0 + h_1), ahol d_k a húrok meredeksége.
+ */
+void bessel_tangent(BesselSpline* spline, int i) {
+  double h0 = spline->h[i - 1], h1 = spline->h[i];
+  double inv = 1.0 / (h0 + h1);
+  spline->tx[i] = (h1 * spline->dx[i - 1] + h0 * spline->dx[i]) * inv;
+  spline->ty[i] = (h1 * spline->dy[i - 1] + h0 * spline->dy[i]) * inv;
+}
+
+/**
+ * Végponti érintők: az első (utolsó) három ponton átmenő parabola deriváltja a végpontban.
+ */
+void bessel_end_tangents(BesselSpline* spline) {
+  int n = spline->n;
+  if (n == 2) {
+    spline->tx[0] = spline->tx[1] = spline->dx[0];
+    spline->ty[0] = spline->ty[1] = spline->dy[0];
+    return;
+  }
+  double h0 = spline->h[0], h1 = spline->h[1];
+  spline->tx[0] = ((2 * h0 + h1) * spline->dx[0] - h0 * spline->dx[1]) / (h0 + h1);
+  spline->ty[0] = ((2 * h0 + h1) * spline->dy[0] - h0 * spline->dy[1]) / (h0 + h1);
+  double ha = spline->h[n - 3], hb = spline->h[n - 2];
+  spline->tx[n - 1] = ((2 * hb + ha) * spline->dx[n - 2] - hb * spline->dx[n - 3]) / (ha + hb);
+  spline->ty[n - 1] = ((2 * hb + ha) * spline->dy[n - 2] - hb * spline->dy[n - 3]) / (ha + hb);
+}
+
+/**
+ * Teljes felépítés: egy menet a húrokra, egy a belső érintőkre.
+ */
+void bessel_spline_build(BesselSpline* spline, Point points[], int n) {
+  spline->n = n;
+  for (int i = 0; i < n - 1; ++i) {
+    bessel_chord(spline, points, i);
+  }
+  for (int i = 1; i < n - 1; ++i) {
+    bessel_tangent(spline, i);
+  }
+  bessel_end_tangents(spline);
 }
 
 /**
- * Kiszámítja a Bessel parabola pontját három vezérlőpont alapján.
+ * A k. pont elmozdult: csak a két szomszédos húr és a k-1, k, k+1 érintők változnak
+ * (a végponti érintők csak akkor, ha k a görbe első vagy utolsó három pontja között van).
  */
-double bessel_parabola(double t, Point points[]) {
-  double x0 = points[0].x, y0 = points[0].y;
-  double x1 = points[1].x, y1 = points[1].y;
-  double x2 = points[2].x, y2 = points[2].y;
-  
-  // Bessel parabola paraméterezése
+void bessel_move_point(BesselSpline* spline, Point points[], int k) {
+  int n = spline->n;
+  if (k > 0) bessel_chord(spline, points, k - 1);
+  if (k < n - 1) bessel_chord(spline, points, k);
+  for (int i = k - 1; i <= k + 1; ++i) {
+    if (i > 0 && i < n - 1) {
+      bessel_tangent(spline, i);
+    }
+  }
+  if (k <= 2 || k >= n - 3) {
+    bessel_end_tangents(spline);
+  }
+}
+
+/**
+ * Az i. szegmens pontja, t a [0, 1] intervallumban (Hermite-bázis, az érintők h_i-vel skálázva).
+ */
+Point bessel_spline_point(const BesselSpline* spline, Point points[], int i, double t) {
   double t2 = t * t;
   double t3 = t2 * t;
-
-  return ((1 - 2 * t + t2) * y0 + (2 * t - 3 * t2 + 1) * y1 + (-t + t2) * y2);
+  double h00 = 2 * t3 - 3 * t2 + 1;
+  double h01 = -2 * t3 + 3 * t2;
+  double h10 = (t3 - 2 * t2 + t) * spline->h[i];
+  double h11 = (t3 - t2) * spline->h[i];
+  Point result = {
+    h00 * points[i].x + h01 * points[i + 1].x + h10 * spline->tx[i] + h11 * spline->tx[i + 1],
+    h00 * points[i].y + h01 * points[i + 1].y + h10 * spline->ty[i] + h11 * spline->ty[i + 1]
+  };
+  return result;
 }
 
 /**
@@ -58,7 +138,8 @@ int main(int argc, char* argv[])
   int i;
 
   Point* selected_point = NULL;
-  Point points[N_POINTS];
+  Point points[MAX_POINTS];
+  int n_points = N_POINTS;
   points[0].x = 200;
   points[0].y = 200;
   points[1].x = 400;
@@ -66,7 +147,8 @@ int main(int argc, char* argv[])
   points[2].x = 300;
   points[2].y = 400;
 
-  Point tangent_point;
+  BesselSpline spline;
+  bessel_spline_build(&spline, points, n_points);
 
   error_code = SDL_Init(SDL_INIT_EVERYTHING);
   if (error_code != 0) {
@@ -88,7 +170,7 @@ int main(int argc, char* argv[])
       case SDL_MOUSEBUTTONDOWN:
         SDL_GetMouseState(&mouse_x, &mouse_y);
         selected_point = NULL;
-        for (int i = 0; i < N_POINTS; ++i) {
+        for (int i = 0; i < n_points; ++i) {
           double dx = points[i].x - mouse_x;
           double dy = points[i].y - mouse_y;
           double distance = sqrt(dx * dx + dy * dy);
@@ -96,36 +178,50 @@ int main(int argc, char* argv[])
             selected_point = points + i;
           }
         }
+        // Jobb klikk üres helyre: új pont a görbe végére
+        if (event.button.button == SDL_BUTTON_RIGHT && selected_point == NULL && n_points < MAX_POINTS) {
+          points[n_points].x = mouse_x;
+          points[n_points].y = mouse_y;
+          ++n_points;
+          bessel_spline_build(&spline, points, n_points);
+        }
         break;
       case SDL_MOUSEMOTION:
         if (selected_point != NULL) {
           SDL_GetMouseState(&mouse_x, &mouse_y);
           selected_point->x = mouse_x;
           selected_point->y = mouse_y;
+          bessel_move_point(&spline, points, (int)(selected_point - points));
         }
 
-        // Redraw the screen with updated points and Bessel parabola
+        // Redraw the screen with updated points and Bessel spline
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
         SDL_RenderClear(renderer);
 
         // Draw the control points
         SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
-        for (int i = 0; i < N_POINTS; ++i) {
+        for (int i = 0; i < n_points; ++i) {
           SDL_RenderDrawLine(renderer, points[i].x - POINT_RADIUS, points[i].y, points[i].x + POINT_RADIUS, points[i].y);
           SDL_RenderDrawLine(renderer, points[i].x, points[i].y - POINT_RADIUS, points[i].x, points[i].y + POINT_RADIUS);
         }
 
-        // Draw the Bessel parabola
+        // Draw the Bessel spline
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
-        for (double t = 0; t <= 1; t += 0.01) {
-          double y = bessel_parabola(t, points);
-          SDL_RenderDrawPoint(renderer, (int)(points[1].x + t * (points[2].x - points[1].x)), (int)y);
+        for (int i = 0; i < n_points - 1; ++i) {
+          Point prev = points[i];
+          for (int j = 1; j <= SAMPLES_PER_SEGMENT; ++j) {
+            Point curr = bessel_spline_point(&spline, points, i, (double)j / SAMPLES_PER_SEGMENT);
+            SDL_RenderDrawLine(renderer, (int)prev.x, (int)prev.y, (int)curr.x, (int)curr.y);
+            prev = curr;
+          }
         }
 
-        // Calculate and draw the tangent at the middle point
-        bessel_tangent(points, &tangent_point);
+        // Draw the cached tangents at every point
         SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
-        SDL_RenderDrawLine(renderer, (int)(tangent_point.x - 100), (int)tangent_point.y, (int)(tangent_point.x + 100), (int)tangent_point.y);
+        for (int i = 0; i < n_points; ++i) {
+          SDL_RenderDrawLine(renderer, (int)(points[i].x - TANGENT_LENGTH * spline.tx[i]), (int)(points[i].y - TANGENT_LENGTH * spline.ty[i]),
+                             (int)(points[i].x + TANGENT_LENGTH * spline.tx[i]), (int)(points[i].y + TANGENT_LENGTH * spline.ty[i]));
+        }
 
         // Display the results
         SDL_RenderPresent(renderer);
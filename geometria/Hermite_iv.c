@@ -5,6 +5,8 @@
 
 const double POINT_RADIUS = 10.0;
 const int N_POINTS = 4;
+#define MAX_POINTS 64
+#define SAMPLES_PER_SEGMENT 32
 
 typedef struct Point {
     double x;
@@ -22,6 +24,126 @@ double hermite(double t, double p0, double p1, double m0, double m1) {
     return h0 * p0 + h1 * p1 + h2 * m0 + h3 * m1;
 }
 
+// Érintők megadási módja
+typedef enum TangentMode {
+    TANGENT_EXPLICIT,     // a tangents[] tömb értékei
+    TANGENT_CATMULL_ROM,  // (P[i+1] - P[i-1]) / 2
+    TANGENT_CARDINAL,     // (1 - tension) * (P[i+1] - P[i-1]) / 2
+    TANGENT_MONOTONE,     // Fritsch-Carlson, koordinátánként monoton
+    TANGENT_MODE_COUNT
+} TangentMode;
+
+const char* TANGENT_MODE_NAMES[TANGENT_MODE_COUNT] = {
+    "explicit", "Catmull-Rom", "cardinal", "monoton (Fritsch-Carlson)"
+};
+
+// Egy szegmens hatványbázisban: p(t) = ((a t + b) t + c) t + d, t a [0, 1] intervallumban
+typedef struct HermiteSegment {
+    Point a, b, c, d;
+} HermiteSegment;
+
+// Fritsch-Carlson érintők egy koordinátára (egyenletes paraméterezés)
+void monotone_tangents(const double v[], int n, double m[]) {
+    m[0] = v[1] - v[0];
+    m[n - 1] = v[n - 1] - v[n - 2];
+    for (int k = 1; k < n - 1; ++k) {
+        double left = v[k] - v[k - 1];
+        double right = v[k + 1] - v[k];
+        // Szélsőértékben vízszintes érintő, különben a két húr átlaga
+        m[k] = left * right > 0 ? (left + right) / 2 : 0.0;
+    }
+    for (int k = 0; k < n - 1; ++k) {
+        double delta = v[k + 1] - v[k];
+        if (delta == 0.0) {
+            m[k] = 0.0;
+            m[k + 1] = 0.0;
+            continue;
+        }
+        double alpha = m[k] / delta;
+        double beta = m[k + 1] / delta;
+        if (alpha < 0.0) m[k] = alpha = 0.0;
+        if (beta < 0.0) m[k + 1] = beta = 0.0;
+        double r = alpha * alpha + beta * beta;
+        if (r > 9.0) {
+            double tau = 3.0 / sqrt(r);
+            m[k] = tau * alpha * delta;
+            m[k + 1] = tau * beta * delta;
+        }
+    }
+}
+
+// A használt érintők a tangents[] tömbbe kerülnek; TANGENT_EXPLICIT esetén a megadott
+// explicit_tangents[] másolata, így a többi módból visszaváltva is azok érvényesek
+void hermite_tangents(Point points[], int n, TangentMode mode, double tension, const Point explicit_tangents[],
+                      Point tangents[]) {
+    if (mode == TANGENT_EXPLICIT || n < 2) {
+        for (int i = 0; i < n; ++i) tangents[i] = explicit_tangents[i];
+        return;
+    }
+    if (mode == TANGENT_MONOTONE) {
+        double v[MAX_POINTS], m[MAX_POINTS];
+        for (int i = 0; i < n; ++i) v[i] = points[i].x;
+        monotone_tangents(v, n, m);
+        for (int i = 0; i < n; ++i) tangents[i].x = m[i];
+        for (int i = 0; i < n; ++i) v[i] = points[i].y;
+        monotone_tangents(v, n, m);
+        for (int i = 0; i < n; ++i) tangents[i].y = m[i];
+        return;
+    }
+    double scale = mode == TANGENT_CARDINAL ? (1.0 - tension) / 2.0 : 0.5;
+    for (int i = 0; i < n; ++i) {
+        Point prev = points[i > 0 ? i - 1 : 0];
+        Point next = points[i < n - 1 ? i + 1 : n - 1];
+        // A végpontokban egyoldali különbség, ugyanazzal a skálával
+        double factor = (i == 0 || i == n - 1) ? 2.0 * scale : scale;
+        tangents[i].x = factor * (next.x - prev.x);
+        tangents[i].y = factor * (next.y - prev.y);
+    }
+}
+
+// Szegmensenként egyszer átváltunk hatványbázisra; n pontból n - 1 szegmens
+void hermite_spline_build(Point points[], Point tangents[], int n, HermiteSegment segments[]) {
+    for (int i = 0; i < n - 1; ++i) {
+        Point p0 = points[i], p1 = points[i + 1];
+        Point m0 = tangents[i], m1 = tangents[i + 1];
+        segments[i].a.x = 2 * p0.x - 2 * p1.x + m0.x + m1.x;
+        segments[i].a.y = 2 * p0.y - 2 * p1.y + m0.y + m1.y;
+        segments[i].b.x = -3 * p0.x + 3 * p1.x - 2 * m0.x - m1.x;
+        segments[i].b.y = -3 * p0.y + 3 * p1.y - 2 * m0.y - m1.y;
+        segments[i].c = m0;
+        segments[i].d = p0;
+    }
+}
+
+// Egy pont a teljes görbén, u a [0, n_segments] intervallumban
+Point hermite_spline_point(const HermiteSegment segments[], int n_segments, double u) {
+    int i = (int)u;
+    if (i >= n_segments) i = n_segments - 1;
+    if (i < 0) i = 0;
+    double t = u - i;
+    const HermiteSegment* s = &segments[i];
+    Point result = {
+        ((s->a.x * t + s->b.x) * t + s->c.x) * t + s->d.x,
+        ((s->a.y * t + s->b.y) * t + s->c.y) * t + s->d.y
+    };
+    return result;
+}
+
+// Kötegelt kiértékelés: szegmensenként samples + 1 egyenletes minta (a közös végpontok egyszer)
+int hermite_spline_evaluate(const HermiteSegment segments[], int n_segments, int samples, Point out[]) {
+    int written = 0;
+    for (int i = 0; i < n_segments; ++i) {
+        const HermiteSegment* s = &segments[i];
+        for (int j = (i == 0 ? 0 : 1); j <= samples; ++j) {
+            double t = (double)j / samples;
+            out[written].x = ((s->a.x * t + s->b.x) * t + s->c.x) * t + s->d.x;
+            out[written].y = ((s->a.y * t + s->b.y) * t + s->c.y) * t + s->d.y;
+            ++written;
+        }
+    }
+    return written;
+}
+
 int main(int argc, char* argv[]) {
     int error_code;
     SDL_Window* window;
@@ -33,7 +155,8 @@ int main(int argc, char* argv[]) {
     int i;
 
     Point* selected_point = NULL;
-    Point points[N_POINTS];
+    Point points[MAX_POINTS];
+    int n_points = N_POINTS;
     points[0].x = 200;
     points[0].y = 200;
     points[1].x = 400;
@@ -43,8 +166,9 @@ int main(int argc, char* argv[]) {
     points[3].x = 400;
     points[3].y = 400;
 
-    // Add tangents (derivatives at each point)
-    Point tangents[N_POINTS];
+    // Add tangents (derivatives at each point); the automatic modes only fill working_tangents
+    Point tangents[MAX_POINTS];
+    Point working_tangents[MAX_POINTS];
     tangents[0].x = 100; // Tangent at P0
     tangents[0].y = 0;
     tangents[1].x = 100; // Tangent at P1
@@ -54,6 +178,11 @@ int main(int argc, char* argv[]) {
     tangents[3].x = -100; // Tangent at P3
     tangents[3].y = 0;
 
+    TangentMode tangent_mode = TANGENT_EXPLICIT;
+    double tension = 0.0;
+    HermiteSegment segments[MAX_POINTS - 1];
+    Point curve[(MAX_POINTS - 1) * SAMPLES_PER_SEGMENT + 1];
+
     error_code = SDL_Init(SDL_INIT_EVERYTHING);
     if (error_code != 0) {
         printf("[ERROR] SDL initialization error: %s\n", SDL_GetError());
@@ -74,7 +203,7 @@ int main(int argc, char* argv[]) {
             case SDL_MOUSEBUTTONDOWN:
                 SDL_GetMouseState(&mouse_x, &mouse_y);
                 selected_point = NULL;
-                for (int i = 0; i < N_POINTS; ++i) {
+                for (int i = 0; i < n_points; ++i) {
                     double dx = points[i].x - mouse_x;
                     double dy = points[i].y - mouse_y;
                     double distance = sqrt(dx * dx + dy * dy);
@@ -82,6 +211,14 @@ int main(int argc, char* argv[]) {
                         selected_point = points + i;
                     }
                 }
+                // Jobb klikk üres helyre: új pont a görbe végére
+                if (event.button.button == SDL_BUTTON_RIGHT && selected_point == NULL && n_points < MAX_POINTS) {
+                    points[n_points].x = mouse_x;
+                    points[n_points].y = mouse_y;
+                    tangents[n_points].x = mouse_x - points[n_points - 1].x;
+                    tangents[n_points].y = mouse_y - points[n_points - 1].y;
+                    ++n_points;
+                }
                 break;
             case SDL_MOUSEMOTION:
                 if (selected_point != NULL) {
@@ -93,26 +230,29 @@ int main(int argc, char* argv[]) {
                 SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
                 SDL_RenderClear(renderer);
 
+                // Tangents and power-basis coefficients are rebuilt once per change
+                hermite_tangents(points, n_points, tangent_mode, tension, tangents, working_tangents);
+                hermite_spline_build(points, working_tangents, n_points, segments);
+
                 // Draw the control points
                 SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
-                for (int i = 0; i < N_POINTS; ++i) {
+                for (int i = 0; i < n_points; ++i) {
                     SDL_RenderDrawLine(renderer, points[i].x - POINT_RADIUS, points[i].y, points[i].x + POINT_RADIUS, points[i].y);
                     SDL_RenderDrawLine(renderer, points[i].x, points[i].y - POINT_RADIUS, points[i].x, points[i].y + POINT_RADIUS);
                 }
 
                 // Draw the tangents (derivatives)
                 SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
-                for (int i = 0; i < N_POINTS; ++i) {
+                for (int i = 0; i < n_points; ++i) {
                     SDL_RenderDrawLine(renderer, points[i].x, points[i].y,
-                                       points[i].x + tangents[i].x, points[i].y + tangents[i].y);
+                                       points[i].x + working_tangents[i].x, points[i].y + working_tangents[i].y);
                 }
 
-                // Draw the Hermite curve
+                // Draw the Hermite spline, every segment
                 SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
-                for (double t = 0; t <= 1; t += 0.01) {
-                    double x = hermite(t, points[0].x, points[1].x, tangents[0].x, tangents[1].x);
-                    double y = hermite(t, points[0].y, points[1].y, tangents[0].y, tangents[1].y);
-                    SDL_RenderDrawPoint(renderer, (int)x, (int)y);
+                int count = hermite_spline_evaluate(segments, n_points - 1, SAMPLES_PER_SEGMENT, curve);
+                for (int i = 1; i < count; ++i) {
+                    SDL_RenderDrawLine(renderer, (int)curve[i - 1].x, (int)curve[i - 1].y, (int)curve[i].x, (int)curve[i].y);
                 }
 
                 // Display the results
@@ -124,6 +264,15 @@ int main(int argc, char* argv[]) {
             case SDL_KEYDOWN:
                 if (event.key.keysym.scancode == SDL_SCANCODE_Q) {
                     need_run = false;
+                } else if (event.key.keysym.sym == SDLK_t) {
+                    tangent_mode = (TangentMode)((tangent_mode + 1) % TANGENT_MODE_COUNT);
+                    printf("Erinto mod: %s\n", TANGENT_MODE_NAMES[tangent_mode]);
+                } else if (event.key.keysym.sym == SDLK_PLUS || event.key.keysym.sym == SDLK_EQUALS) {
+                    tension = tension + 0.1 > 1.0 ? 1.0 : tension + 0.1;
+                    printf("Feszitettseg: %.1f\n", tension);
+                } else if (event.key.keysym.sym == SDLK_MINUS) {
+                    tension = tension - 0.1 < -1.0 ? -1.0 : tension - 0.1;
+                    printf("Feszitettseg: %.1f\n", tension);
                 }
                 break;
             case SDL_QUIT:
@@ -0,0 +1,437 @@
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const double POINT_RADIUS = 10.0;
+const int N_POINTS = 6;
+#define MAX_POINTS 256
+#define BENCH_POINTS 1000000
+
+/**
+ * A simple point structure.
+ */
+typedef struct Point
+{
+    double x;
+    double y;
+} Point;
+
+/**
+ * Peremfeltételek a globális C2 köbös spline-hoz.
+ */
+typedef enum EndCondition
+{
+    END_NATURAL,   // S''(x_0) = S''(x_n-1) = 0
+    END_CLAMPED,   // előírt meredekség a két végen
+    END_PERIODIC,  // y_n-1 = y_0 kell legyen, S' és S'' is periodikus
+    END_CONDITION_COUNT
+} EndCondition;
+
+const char* END_CONDITION_NAMES[END_CONDITION_COUNT] = { "natural", "clamped", "periodic" };
+
+/**
+ * Köbös spline a második deriváltakkal (momentumokkal) tárolva. Az x és y tömböket
+ * nem másoljuk; x szigorúan növekvő kell legyen. Minden munkaterület O(n).
+ */
+typedef struct CubicSpline
+{
+    const double* x;
+    const double* y;
+    int n;
+    double* m;         // S''(x_i)
+    double* work;      // 5n segédtömb a tridiagonális megoldóhoz
+    int capacity;
+} CubicSpline;
+
+void spline_free(CubicSpline* spline) {
+    free(spline->m);
+    free(spline->work);
+    spline->m = NULL;
+    spline->work = NULL;
+    spline->capacity = 0;
+}
+
+/**
+ * Thomas-algoritmus: a_i x_(i-1) + b_i x_i + c_i x_(i+1) = r_i, O(n).
+ * a[0] és c[n-1] nem használt. A megoldás r-be kerül, scratch n elemű.
+ */
+void solve_tridiagonal(const double a[], const double b[], const double c[], double r[], int n, double scratch[]) {
+    scratch[0] = c[0] / b[0];
+    r[0] = r[0] / b[0];
+    for (int i = 1; i < n; ++i) {
+        double denom = b[i] - a[i] * scratch[i - 1];
+        scratch[i] = c[i] / denom;
+        r[i] = (r[i] - a[i] * r[i - 1]) / denom;
+    }
+    for (int i = n - 2; i >= 0; --i) {
+        r[i] -= scratch[i] * r[i + 1];
+    }
+}
+
+/**
+ * Spline illesztése. END_CLAMPED esetén slope_start és slope_end a két végpont
+ * meredeksége, a többi peremfeltételnél nem használt. Periodikus esetben a ciklikus
+ * rendszert Sherman-Morrison képlettel két Thomas-megoldásra vezetjük vissza, így
+ * az is O(n). Hamissal tér vissza, ha az x értékek nem szigorúan növekvők.
+ */
+bool spline_fit(CubicSpline* spline, const double x[], const double y[], int n,
+                EndCondition end, double slope_start, double slope_end) {
+    if (n < 2 || (end == END_PERIODIC && n < 3)) {
+        return false;
+    }
+    for (int i = 1; i < n; ++i) {
+        if (!(x[i] > x[i - 1])) {
+            return false;
+        }
+    }
+    if (n > spline->capacity) {
+        free(spline->m);
+        free(spline->work);
+        spline->m = malloc(n * sizeof(double));
+        spline->work = malloc(5 * n * sizeof(double));
+        spline->capacity = spline->m != NULL && spline->work != NULL ? n : 0;
+        if (spline->capacity == 0) {
+            spline_free(spline);
+            return false;
+        }
+    }
+    spline->x = x;
+    spline->y = y;
+    spline->n = n;
+
+    double* m = spline->m;
+    double* a = spline->work;
+    double* b = a + n;
+    double* c = b + n;
+    double* scratch = c + n;
+
+    if (end == END_NATURAL && n == 2) {
+        m[0] = m[1] = 0.0;
+        return true;
+    }
+
+    if (end == END_PERIODIC) {
+        // n - 1 ismeretlen: M_0..M_(n-2), M_(n-1) = M_0
+        int k = n - 1;
+        for (int i = 0; i < k; ++i) {
+            int prev = (i + k - 1) % k;
+            double h_prev = x[prev + 1] - x[prev];
+            double h = x[i + 1] - x[i];
+            a[i] = h_prev;
+            b[i] = 2.0 * (h_prev + h);
+            c[i] = h;
+            m[i] = 6.0 * ((y[i + 1] - y[i]) / h - (y[prev + 1] - y[prev]) / h_prev);
+        }
+        if (k == 2) {
+            // Két ismeretlennél a sarokelemek a főátló melletti elemekhez adódnak
+            double a01 = c[0] + a[0], a10 = a[1] + c[1];
+            double det = b[0] * b[1] - a01 * a10;
+            double m0 = (m[0] * b[1] - a01 * m[1]) / det;
+            double m1 = (b[0] * m[1] - a10 * m[0]) / det;
+            m[0] = m0;
+            m[1] = m1;
+            m[2] = m0;
+            return true;
+        }
+        double alpha = a[0];      // jobb felső sarok: A[0][k-1]
+        double beta = c[k - 1];   // bal alsó sarok: A[k-1][0]
+        double gamma = -b[0];
+        b[0] -= gamma;
+        b[k - 1] -= alpha * beta / gamma;
+        solve_tridiagonal(a, b, c, m, k, scratch);
+        // z = A'^-1 u, u = (gamma, 0, ..., 0, beta)
+        double* z = scratch + n;
+        for (int i = 0; i < k; ++i) {
+            z[i] = 0.0;
+        }
+        z[0] = gamma;
+        z[k - 1] = beta;
+        solve_tridiagonal(a, b, c, z, k, scratch);
+        double factor = (m[0] + alpha * m[k - 1] / gamma) / (1.0 + z[0] + alpha * z[k - 1] / gamma);
+        for (int i = 0; i < k; ++i) {
+            m[i] -= factor * z[i];
+        }
+        m[k] = m[0];
+        return true;
+    }
+
+    for (int i = 1; i < n - 1; ++i) {
+        double h_prev = x[i] - x[i - 1];
+        double h = x[i + 1] - x[i];
+        a[i] = h_prev;
+        b[i] = 2.0 * (h_prev + h);
+        c[i] = h;
+        m[i] = 6.0 * ((y[i + 1] - y[i]) / h - (y[i] - y[i - 1]) / h_prev);
+    }
+    if (end == END_CLAMPED) {
+        double h0 = x[1] - x[0];
+        double hn = x[n - 1] - x[n - 2];
+        b[0] = 2.0 * h0;
+        c[0] = h0;
+        m[0] = 6.0 * ((y[1] - y[0]) / h0 - slope_start);
+        a[n - 1] = hn;
+        b[n - 1] = 2.0 * hn;
+        m[n - 1] = 6.0 * (slope_end - (y[n - 1] - y[n - 2]) / hn);
+    } else {
+        b[0] = 1.0;
+        c[0] = 0.0;
+        m[0] = 0.0;
+        a[n - 1] = 0.0;
+        b[n - 1] = 1.0;
+        m[n - 1] = 0.0;
+    }
+    solve_tridiagonal(a, b, c, m, n, scratch);
+    return true;
+}
+
+/**
+ * Kiértékelés az i. intervallumon, x_i <= t <= x_(i+1).
+ */
+double spline_segment(const CubicSpline* spline, int i, double t) {
+    const double* x = spline->x;
+    const double* y = spline->y;
+    const double* m = spline->m;
+    double h = x[i + 1] - x[i];
+    double a = x[i + 1] - t;
+    double b = t - x[i];
+    return (m[i] * a * a * a + m[i + 1] * b * b * b) / (6.0 * h)
+         + (y[i] / h - m[i] * h / 6.0) * a
+         + (y[i + 1] / h - m[i + 1] * h / 6.0) * b;
+}
+
+/**
+ * Az intervallum keresése bináris kereséssel, O(log n).
+ */
+int spline_find_interval(const CubicSpline* spline, double t) {
+    int lo = 0, hi = spline->n - 2;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (spline->x[mid] <= t) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+double spline_evaluate(const CubicSpline* spline, double t) {
+    return spline_segment(spline, spline_find_interval(spline, t), t);
+}
+
+/**
+ * Monoton (növekvő) lekérdezésekhez: a cursor az előző hívás intervalluma.
+ * Ha t ugyanabban vagy a következő néhány intervallumban van, nincs keresés.
+ */
+double spline_evaluate_cursor(const CubicSpline* spline, double t, int* cursor) {
+    int i = *cursor;
+    if (i < 0 || i > spline->n - 2 || t < spline->x[i]) {
+        i = spline_find_interval(spline, t);
+    } else {
+        int steps = 0;
+        while (i < spline->n - 2 && t >= spline->x[i + 1] && steps < 4) {
+            ++i;
+            ++steps;
+        }
+        if (i < spline->n - 2 && t >= spline->x[i + 1]) {
+            i = spline_find_interval(spline, t);
+        }
+    }
+    *cursor = i;
+    return spline_segment(spline, i, t);
+}
+
+/**
+ * Mérés: BENCH_POINTS mintapont illesztése mindhárom peremfeltétellel, majd
+ * ugyanannyi monoton lekérdezés bináris kereséssel és kurzorral.
+ */
+int run_benchmark(void) {
+    double* x = malloc(BENCH_POINTS * sizeof(double));
+    double* y = malloc(BENCH_POINTS * sizeof(double));
+    double* out = malloc(BENCH_POINTS * sizeof(double));
+    if (x == NULL || y == NULL || out == NULL) {
+        printf("[ERROR] Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_POINTS; ++i) {
+        x[i] = i * 0.001 + 0.0004 * sin(i * 0.37);
+        y[i] = sin(x[i]) + 0.1 * cos(7.0 * x[i]);
+    }
+    y[BENCH_POINTS - 1] = y[0];
+
+    CubicSpline spline = { 0 };
+    double freq = (double)SDL_GetPerformanceFrequency();
+    for (int end = 0; end < END_CONDITION_COUNT; ++end) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        bool ok = spline_fit(&spline, x, y, BENCH_POINTS, (EndCondition)end, 1.0, 1.0);
+        double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / freq;
+        printf("Illesztes (%s, %d pont): %.2f ms%s\n", END_CONDITION_NAMES[end], BENCH_POINTS, ms, ok ? "" : " HIBA");
+    }
+
+    double span = x[BENCH_POINTS - 1] - x[0];
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_POINTS; ++i) {
+        out[i] = spline_evaluate(&spline, x[0] + span * i / BENCH_POINTS);
+    }
+    double binary_ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / freq;
+    double checksum = out[BENCH_POINTS / 2];
+
+    int cursor = 0;
+    start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < BENCH_POINTS; ++i) {
+        out[i] = spline_evaluate_cursor(&spline, x[0] + span * i / BENCH_POINTS, &cursor);
+    }
+    double cursor_ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / freq;
+    printf("Kiertekeles: binaris kereses %.2f ms, kurzor %.2f ms (elteres: %g)\n",
+           binary_ms, cursor_ms, fabs(checksum - out[BENCH_POINTS / 2]));
+
+    spline_free(&spline);
+    free(x);
+    free(y);
+    free(out);
+    return 0;
+}
+
+/**
+ * C/SDL2 framework for experimentation with curves.
+ * "bench" argumentummal ablak nélkül a nagy pontszámú mérést futtatja.
+ */
+int main(int argc, char* argv[])
+{
+    int error_code;
+    SDL_Window* window;
+    bool need_run;
+    SDL_Event event;
+    SDL_Renderer* renderer;
+
+    int mouse_x, mouse_y;
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return run_benchmark();
+    }
+
+    Point* selected_point = NULL;
+    Point points[MAX_POINTS];
+    int n_points = N_POINTS;
+    for (int i = 0; i < n_points; ++i) {
+        points[i].x = 150 + i * 100;
+        points[i].y = i % 2 == 0 ? 250 : 350;
+    }
+
+    EndCondition end_condition = END_NATURAL;
+    CubicSpline spline = { 0 };
+    double xs[MAX_POINTS], ys[MAX_POINTS];
+    SDL_Point curve[800];
+
+    error_code = SDL_Init(SDL_INIT_EVERYTHING);
+    if (error_code != 0) {
+        printf("[ERROR] SDL initialization error: %s\n", SDL_GetError());
+        return error_code;
+    }
+
+    window = SDL_CreateWindow(
+        "Cubic Spline Interpolation",
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+        800, 600, 0);
+
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+
+    need_run = true;
+    while (need_run) {
+        while (SDL_PollEvent(&event)) {
+            switch (event.type) {
+            case SDL_MOUSEBUTTONDOWN:
+                SDL_GetMouseState(&mouse_x, &mouse_y);
+                selected_point = NULL;
+                for (int i = 0; i < n_points; ++i) {
+                    double dx = points[i].x - mouse_x;
+                    double dy = points[i].y - mouse_y;
+                    double distance = sqrt(dx * dx + dy * dy);
+                    if (distance < POINT_RADIUS) {
+                        selected_point = points + i;
+                    }
+                }
+                // Jobb klikk üres helyre: új csomópont
+                if (event.button.button == SDL_BUTTON_RIGHT && selected_point == NULL && n_points < MAX_POINTS) {
+                    points[n_points].x = mouse_x;
+                    points[n_points].y = mouse_y;
+                    ++n_points;
+                }
+                break;
+            case SDL_MOUSEMOTION:
+                if (selected_point != NULL) {
+                    SDL_GetMouseState(&mouse_x, &mouse_y);
+                    selected_point->x = mouse_x;
+                    selected_point->y = mouse_y;
+                }
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+                SDL_RenderClear(renderer);
+
+                // Draw the control points
+                SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
+                for (int i = 0; i < n_points; ++i) {
+                    SDL_RenderDrawLine(renderer, points[i].x - POINT_RADIUS, points[i].y, points[i].x + POINT_RADIUS, points[i].y);
+                    SDL_RenderDrawLine(renderer, points[i].x, points[i].y - POINT_RADIUS, points[i].x, points[i].y + POINT_RADIUS);
+                }
+
+                // A csomópontok x szerint rendezve (beszúrásos rendezés, húzás közben szinte rendezett)
+                for (int i = 0; i < n_points; ++i) {
+                    int j = i;
+                    while (j > 0 && xs[j - 1] > points[i].x) {
+                        xs[j] = xs[j - 1];
+                        ys[j] = ys[j - 1];
+                        --j;
+                    }
+                    xs[j] = points[i].x;
+                    ys[j] = points[i].y;
+                }
+                double slope_start = (ys[1] - ys[0]) / (xs[1] - xs[0]);
+                double slope_end = (ys[n_points - 1] - ys[n_points - 2]) / (xs[n_points - 1] - xs[n_points - 2]);
+                if (end_condition == END_PERIODIC) {
+                    ys[n_points - 1] = ys[0];
+                }
+
+                // Draw the spline, one monotone query per pixel column
+                if (spline_fit(&spline, xs, ys, n_points, end_condition, slope_start, slope_end)) {
+                    int count = 0;
+                    int cursor = 0;
+                    for (int px = (int)ceil(xs[0]); px <= (int)xs[n_points - 1] && count < 800; ++px) {
+                        curve[count].x = px;
+                        curve[count].y = (int)spline_evaluate_cursor(&spline, px, &cursor);
+                        ++count;
+                    }
+                    SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+                    SDL_RenderDrawLines(renderer, curve, count);
+                }
+
+                // Display the results
+                SDL_RenderPresent(renderer);
+                break;
+            case SDL_MOUSEBUTTONUP:
+                selected_point = NULL;
+                break;
+            case SDL_KEYDOWN:
+                if (event.key.keysym.scancode == SDL_SCANCODE_Q) {
+                    need_run = false;
+                } else if (event.key.keysym.sym == SDLK_e) {
+                    end_condition = (EndCondition)((end_condition + 1) % END_CONDITION_COUNT);
+                    printf("Peremfeltetel: %s\n", END_CONDITION_NAMES[end_condition]);
+                }
+                break;
+            case SDL_QUIT:
+                need_run = false;
+                break;
+            }
+        }
+    }
+
+    spline_free(&spline);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    return 0;
+}
@@ -5,6 +5,9 @@
 
 const double POINT_RADIUS = 10.0;
 const int N_POINTS = 4;
+#define MAX_NODES 64
+#define CURVE_SAMPLES 1024
+#define GRID_BLOCK 256
 
 /**
  * A simple point structure.
@@ -17,11 +20,16 @@ typedef struct Point
 
 /**
  * Lagrange bázispolinomok számítása a k-i pontokhoz.
+ * Azonos x-ű csomópontokra a bázis nem értelmezett: az eredmény NAN, nem végtelen
+ * vagy véletlenszerű szám, így az interpoláció is NAN lesz.
  */
-double lagrange_basis(int i, double t, Point points[]) {
+double lagrange_basis(int i, double t, Point points[], int n) {
     double result = 1.0;
-    for (int j = 0; j < N_POINTS; ++j) {
+    for (int j = 0; j < n; ++j) {
         if (i != j) {
+            if (points[i].x == points[j].x) {
+                return NAN;
+            }
             result *= (t - points[j].x) / (points[i].x - points[j].x);
         }
     }
@@ -31,14 +39,288 @@ double lagrange_basis(int i, double t, Point points[]) {
 /**
  * Lagrange interpolációs polinom kiszámítása.
  */
-double lagrange_interpolation(double t, Point points[]) {
+double lagrange_interpolation(double t, Point points[], int n) {
     double result = 0.0;
-    for (int i = 0; i < N_POINTS; ++i) {
-        result += points[i].y * lagrange_basis(i, t, points);
+    for (int i = 0; i < n; ++i) {
+        result += points[i].y * lagrange_basis(i, t, points, n);
     }
     return result;
 }
 
+/**
+ * Baricentrikus (második alakú) Lagrange interpoláció előre kiszámított súlyokkal.
+ * A súlyok közös skálázása kiesik a képletből, ezért a csomópontok távolságait
+ * 4 / (xmax - xmin)-nel szorozzuk, így sok csomópontnál sincs túl- vagy alulcsordulás.
+ */
+typedef struct BarycentricWeights
+{
+    double w[MAX_NODES];
+    double scale;
+    bool valid; // hamis, ha két csomópontnak azonos az x koordinátája
+} BarycentricWeights;
+
+/**
+ * Súlyok teljes újraszámítása, O(n^2). Azonos x-ek esetén az interpoláció
+ * nem értelmezett: valid = false, és a kirajzolás kimarad.
+ */
+bool barycentric_weights(BarycentricWeights* bw, Point points[], int n) {
+    double x_min = points[0].x, x_max = points[0].x;
+    for (int j = 1; j < n; ++j) {
+        if (points[j].x < x_min) x_min = points[j].x;
+        if (points[j].x > x_max) x_max = points[j].x;
+    }
+    bw->scale = x_max > x_min ? 4.0 / (x_max - x_min) : 1.0;
+    bw->valid = true;
+    for (int j = 0; j < n; ++j) {
+        double product = 1.0;
+        for (int k = 0; k < n; ++k) {
+            if (k != j) {
+                double diff = (points[j].x - points[k].x) * bw->scale;
+                if (diff == 0.0) {
+                    bw->valid = false;
+                    return false;
+                }
+                product *= diff;
+            }
+        }
+        bw->w[j] = 1.0 / product;
+    }
+    return true;
+}
+
+/**
+ * A k. csomópont x koordinátája old_x-ről points[k].x-re változott: O(n) frissítés.
+ * A többi súly csak egy tényezővel módosul, w_k-t pedig újraszámoljuk.
+ */
+bool barycentric_move_node(BarycentricWeights* bw, Point points[], int n, int k, double old_x) {
+    if (!bw->valid || old_x == points[k].x) {
+        return bw->valid || barycentric_weights(bw, points, n);
+    }
+    double product = 1.0;
+    for (int j = 0; j < n; ++j) {
+        if (j != k) {
+            double diff = points[j].x - points[k].x;
+            if (diff == 0.0) {
+                bw->valid = false;
+                return false;
+            }
+            bw->w[j] *= (points[j].x - old_x) / diff;
+            product *= -diff * bw->scale;
+        }
+    }
+    bw->w[k] = 1.0 / product;
+    return true;
+}
+
+/**
+ * Az interpolációs polinom értéke t-ben, O(n). Csomópontban pontosan y_j.
+ */
+double barycentric_interpolation(double t, const BarycentricWeights* bw, Point points[], int n) {
+    double numerator = 0.0, denominator = 0.0;
+    for (int j = 0; j < n; ++j) {
+        double diff = t - points[j].x;
+        if (diff == 0.0) {
+            return points[j].y;
+        }
+        double c = bw->w[j] / diff;
+        numerator += c * points[j].y;
+        denominator += c;
+    }
+    return numerator / denominator;
+}
+
+/**
+ * Kiértékelés a t0, t0 + dt, ... rácson. A csomópontok a külső ciklusban vannak,
+ * így a belső ciklus egyszerű, vektorizálható összegzés egy blokknyi mintára.
+ */
+void barycentric_interpolation_grid(double t0, double dt, int count, const BarycentricWeights* bw,
+                                    Point points[], int n, double out[]) {
+    double numerator[GRID_BLOCK], denominator[GRID_BLOCK];
+    for (int start = 0; start < count; start += GRID_BLOCK) {
+        int block = count - start < GRID_BLOCK ? count - start : GRID_BLOCK;
+        for (int s = 0; s < block; ++s) {
+            numerator[s] = 0.0;
+            denominator[s] = 0.0;
+        }
+        for (int j = 0; j < n; ++j) {
+            double wy = bw->w[j] * points[j].y;
+            for (int s = 0; s < block; ++s) {
+                double inv = 1.0 / (t0 + (start + s) * dt - points[j].x);
+                numerator[s] += wy * inv;
+                denominator[s] += bw->w[j] * inv;
+            }
+        }
+        for (int s = 0; s < block; ++s) {
+            out[start + s] = numerator[s] / denominator[s];
+        }
+        // Csomópontra eső minták: 1/0 miatt inf/inf, ott a pontos értéket írjuk vissza
+        for (int j = 0; j < n; ++j) {
+            double index = (points[j].x - t0) / dt - start;
+            int s = (int)index;
+            if (index >= 0.0 && s < block && t0 + (start + s) * dt == points[j].x) {
+                out[start + s] = points[j].y;
+            }
+        }
+    }
+}
+
+/**
+ * Newton-alakú interpoláció osztott differenciákkal. A tábla i. sora az i. beszúrt
+ * csomóponthoz tartozó f[x_i], f[x_(i-1), x_i], ..., f[x_0..x_i] értékeket tárolja,
+ * az i. Newton-együttható a sor utolsó eleme. Egy új sor csak az előző sortól
+ * függ, ezért beszúráskor és az utolsó sor csomópontjának mozgatásakor O(n) a frissítés.
+ */
+typedef struct NewtonInterpolant
+{
+    double x[MAX_NODES];
+    double table[MAX_NODES][MAX_NODES];
+    int node[MAX_NODES]; // a tábla i. sora melyik points[] elemhez tartozik
+    int n;
+    bool valid;          // hamis, ha két csomópontnak azonos az x koordinátája
+} NewtonInterpolant;
+
+/**
+ * A tábla i. sorának kiszámítása az (i-1). sorból, O(i).
+ */
+bool newton_fill_row(NewtonInterpolant* ni, int i, Point points[]) {
+    double* row = ni->table[i];
+    ni->x[i] = points[ni->node[i]].x;
+    row[0] = points[ni->node[i]].y;
+    for (int j = 1; j <= i; ++j) {
+        double diff = ni->x[i] - ni->x[i - j];
+        if (diff == 0.0) {
+            return false;
+        }
+        row[j] = (row[j - 1] - ni->table[i - 1][j - 1]) / diff;
+    }
+    return true;
+}
+
+/**
+ * Teljes újraépítés a meglévő sorrendben, O(n^2).
+ */
+bool newton_rebuild(NewtonInterpolant* ni, Point points[]) {
+    ni->valid = true;
+    for (int i = 0; i < ni->n; ++i) {
+        if (!newton_fill_row(ni, i, points)) {
+            ni->valid = false;
+            break;
+        }
+    }
+    return ni->valid;
+}
+
+void newton_init(NewtonInterpolant* ni, Point points[], int n) {
+    ni->n = n;
+    for (int i = 0; i < n; ++i) {
+        ni->node[i] = i;
+    }
+    newton_rebuild(ni, points);
+}
+
+/**
+ * Új csomópont (points[index]) hozzáfűzése a tábla végére, O(n).
+ */
+bool newton_append(NewtonInterpolant* ni, Point points[], int index) {
+    ni->node[ni->n++] = index;
+    if (!ni->valid) {
+        return newton_rebuild(ni, points);
+    }
+    ni->valid = newton_fill_row(ni, ni->n - 1, points);
+    return ni->valid;
+}
+
+/**
+ * A points[index] csomópont áthelyezése a tábla utolsó sorába. Ezt húzás kezdetén
+ * egyszer hívjuk; utána minden mozgatás csak az utolsó sort érinti.
+ */
+void newton_make_last(NewtonInterpolant* ni, Point points[], int index) {
+    int r = 0;
+    while (r < ni->n && ni->node[r] != index) {
+        ++r;
+    }
+    if (r >= ni->n - 1) {
+        return;
+    }
+    for (int i = r; i < ni->n - 1; ++i) {
+        ni->node[i] = ni->node[i + 1];
+    }
+    ni->node[ni->n - 1] = index;
+    if (!ni->valid) {
+        newton_rebuild(ni, points);
+        return;
+    }
+    for (int i = r; i < ni->n; ++i) {
+        if (!newton_fill_row(ni, i, points)) {
+            ni->valid = false;
+            return;
+        }
+    }
+}
+
+/**
+ * Az utolsó sor csomópontja elmozdult: csak ez a sor változik, O(n).
+ */
+bool newton_update_last(NewtonInterpolant* ni, Point points[]) {
+    if (!ni->valid) {
+        return newton_rebuild(ni, points);
+    }
+    ni->valid = newton_fill_row(ni, ni->n - 1, points);
+    return ni->valid;
+}
+
+/**
+ * A points[index] csomópont törlése: az utolsó sorba kerül, majd elhagyjuk.
+ * A points[] tömb utolsó eleme kerül az index helyére, a táblában is átszámozzuk.
+ * Visszatér az új csomópontszámmal.
+ */
+int newton_remove(NewtonInterpolant* ni, Point points[], int index) {
+    newton_make_last(ni, points, index);
+    ni->n--;
+    points[index] = points[ni->n];
+    for (int i = 0; i < ni->n; ++i) {
+        if (ni->node[i] == ni->n) {
+            ni->node[i] = index;
+        }
+    }
+    if (!ni->valid) {
+        newton_rebuild(ni, points);
+    }
+    return ni->n;
+}
+
+/**
+ * Kiértékelés beágyazott (Horner-szerű) alakban, O(n).
+ */
+double newton_interpolation(double t, const NewtonInterpolant* ni) {
+    double result = ni->table[ni->n - 1][ni->n - 1];
+    for (int i = ni->n - 2; i >= 0; --i) {
+        result = result * (t - ni->x[i]) + ni->table[i][i];
+    }
+    return result;
+}
+
+/**
+ * A csomópontok x koordinátáit a jelenlegi tartomány Csebisev-pontjaira tesszük
+ * (sorrendjük megmarad), ami sok csomópontnál elnyomja a Runge-jelenséget.
+ */
+void chebyshev_spacing(Point points[], int n) {
+    int order[MAX_NODES];
+    for (int i = 0; i < n; ++i) {
+        int j = i;
+        while (j > 0 && points[order[j - 1]].x > points[i].x) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = i;
+    }
+    double x_min = points[order[0]].x, x_max = points[order[n - 1]].x;
+    for (int k = 0; k < n; ++k) {
+        double c = -cos(M_PI * (2 * k + 1) / (2.0 * n)) / cos(M_PI / (2.0 * n));
+        points[order[k]].x = floor(0.5 * (x_min + x_max) + 0.5 * (x_max - x_min) * c + 0.5);
+    }
+}
+
 /**
  * C/SDL2 framework for experimentation with curves.
  */
@@ -54,7 +336,9 @@ int main(int argc, char* argv[])
     int i;
 
     Point* selected_point = NULL;
-    Point points[N_POINTS];
+    double selected_old_x = 0.0;
+    Point points[MAX_NODES];
+    int n_points = N_POINTS;
     points[0].x = 200;
     points[0].y = 200;
     points[1].x = 400;
@@ -64,6 +348,14 @@ int main(int argc, char* argv[])
     points[3].x = 400;
     points[3].y = 400;
 
+    BarycentricWeights weights;
+    NewtonInterpolant newton;
+    bool use_newton = true;
+    double curve_y[CURVE_SAMPLES];
+    SDL_Point curve[CURVE_SAMPLES];
+    barycentric_weights(&weights, points, n_points);
+    newton_init(&newton, points, n_points);
+
     error_code = SDL_Init(SDL_INIT_EVERYTHING);
     if (error_code != 0) {
         printf("[ERROR] SDL initialization error: %s\n", SDL_GetError());
@@ -84,7 +376,7 @@ int main(int argc, char* argv[])
             case SDL_MOUSEBUTTONDOWN:
                 SDL_GetMouseState(&mouse_x, &mouse_y);
                 selected_point = NULL;
-                for (int i = 0; i < N_POINTS; ++i) {
+                for (int i = 0; i < n_points; ++i) {
                     double dx = points[i].x - mouse_x;
                     double dy = points[i].y - mouse_y;
                     double distance = sqrt(dx * dx + dy * dy);
@@ -92,12 +384,32 @@ int main(int argc, char* argv[])
                         selected_point = points + i;
                     }
                 }
+                if (event.button.button == SDL_BUTTON_RIGHT) {
+                    // Jobb klikk: csomópont törlése, vagy új csomópont a kurzor helyén
+                    if (selected_point != NULL && n_points > 2) {
+                        n_points = newton_remove(&newton, points, (int)(selected_point - points));
+                    } else if (selected_point == NULL && n_points < MAX_NODES) {
+                        points[n_points].x = mouse_x;
+                        points[n_points].y = mouse_y;
+                        newton_append(&newton, points, n_points);
+                        ++n_points;
+                    }
+                    selected_point = NULL;
+                } else if (selected_point != NULL) {
+                    // Húzás közben csak a Newton-tábla utolsó sora változik
+                    newton_make_last(&newton, points, (int)(selected_point - points));
+                }
+                // Új húzás: a lépésenkénti frissítések kerekítési hibáját nullázzuk
+                barycentric_weights(&weights, points, n_points);
                 break;
             case SDL_MOUSEMOTION:
                 if (selected_point != NULL) {
                     SDL_GetMouseState(&mouse_x, &mouse_y);
+                    selected_old_x = selected_point->x;
                     selected_point->x = mouse_x;
                     selected_point->y = mouse_y;
+                    barycentric_move_node(&weights, points, n_points, (int)(selected_point - points), selected_old_x);
+                    newton_update_last(&newton, points);
                 }
                 // Draw Lagrange curve
                 SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
@@ -105,22 +417,42 @@ int main(int argc, char* argv[])
 
                 // Draw the control points
                 SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE);
-                for (int i = 0; i < N_POINTS; ++i) {
+                for (int i = 0; i < n_points; ++i) {
                     SDL_RenderDrawLine(renderer, points[i].x - POINT_RADIUS, points[i].y, points[i].x + POINT_RADIUS, points[i].y);
                     SDL_RenderDrawLine(renderer, points[i].x, points[i].y - POINT_RADIUS, points[i].x, points[i].y + POINT_RADIUS);
                 }
 
                 // Draw the segments
                 SDL_SetRenderDrawColor(renderer, 160, 160, 160, SDL_ALPHA_OPAQUE);
-                for (int i = 1; i < N_POINTS; ++i) {
+                for (int i = 1; i < n_points; ++i) {
                     SDL_RenderDrawLine(renderer, points[i - 1].x, points[i - 1].y, points[i].x, points[i].y);
                 }
 
-                // Draw the Lagrange interpolated curve
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
-                for (double t = points[0].x; t <= points[N_POINTS - 1].x; t += 0.01) {
-                    double y = lagrange_interpolation(t, points);
-                    SDL_RenderDrawPoint(renderer, (int)t, (int)y);
+                // Draw the Lagrange interpolated curve (one sample per pixel column)
+                double x_min = points[0].x, x_max = points[0].x;
+                for (int i = 1; i < n_points; ++i) {
+                    if (points[i].x < x_min) x_min = points[i].x;
+                    if (points[i].x > x_max) x_max = points[i].x;
+                }
+                bool valid = use_newton ? newton.valid : weights.valid;
+                if (valid && x_max > x_min) {
+                    int count = (int)(x_max - x_min) + 1;
+                    if (count > CURVE_SAMPLES) {
+                        count = CURVE_SAMPLES;
+                    }
+                    if (use_newton) {
+                        for (int s = 0; s < count; ++s) {
+                            curve_y[s] = newton_interpolation(x_min + s, &newton);
+                        }
+                    } else {
+                        barycentric_interpolation_grid(x_min, 1.0, count, &weights, points, n_points, curve_y);
+                    }
+                    for (int s = 0; s < count; ++s) {
+                        curve[s].x = (int)(x_min + s);
+                        curve[s].y = (int)curve_y[s];
+                    }
+                    SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+                    SDL_RenderDrawLines(renderer, curve, count);
                 }
 
                 // Display the results
@@ -132,6 +464,14 @@ int main(int argc, char* argv[])
             case SDL_KEYDOWN:
                 if (event.key.keysym.scancode == SDL_SCANCODE_Q) {
                     need_run = false;
+                } else if (event.key.keysym.sym == SDLK_n) {
+                    // Newton- és baricentrikus kiértékelés váltása
+                    use_newton = !use_newton;
+                    printf("%s\n", use_newton ? "Newton-alak" : "Baricentrikus alak");
+                } else if (event.key.keysym.sym == SDLK_c) {
+                    chebyshev_spacing(points, n_points);
+                    barycentric_weights(&weights, points, n_points);
+                    newton_rebuild(&newton, points);
                 }
                 break;
             case SDL_QUIT:
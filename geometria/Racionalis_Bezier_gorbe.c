@@ -5,10 +5,13 @@
 
 const double POINT_RADIUS = 10.0;
 const int N_POINTS = 4;
+#define N_POINTS_MAX 4  // Array size for the per-point caches
 const int WEIGHT_SLIDER_WIDTH = 150;
 const int WEIGHT_SLIDER_HEIGHT = 10;
 const int SLIDER_Y_OFFSET = 50;
 const double MAX_WEIGHT = 10.0;  // Maximum weight for sliders
+const double DENOMINATOR_EPSILON = 1e-12;  // Weight sums below this count as zero
+#define CURVE_STEPS 100  // Curve samples are taken at t = i / CURVE_STEPS
 
 /**
  * A simple point structure.
@@ -29,15 +32,14 @@ typedef struct WeightedPoint
 } WeightedPoint;
 
 /**
- * Calculate the factorial of a number.
+ * Binomial coefficient C(n, i) as a running product in double. The former
+ * n! / (i! (n - i)!) in int overflowed from n = 13 on.
  */
-int factorial(int n)
+double binomial(int n, int i)
 {
-  if (n == 0 || n == 1)
-    return 1;
-  int result = 1;
-  for (int i = 2; i <= n; i++)
-    result *= i;
+  double result = 1.0;
+  for (int k = 1; k <= i; ++k)
+    result = result * (n - i + k) / k;
   return result;
 }
 
@@ -46,42 +48,100 @@ int factorial(int n)
  */
 double bernstein(int i, int n, double t)
 {
-  return (factorial(n) / (factorial(i) * factorial(n - i))) * pow(t, i) * pow(1 - t, n - i);
+  return binomial(n, i) * pow(t, i) * pow(1 - t, n - i);
 }
 
 /**
- * Calculate a rational Bézier curve point.
+ * Projected point of the homogeneous sums. All weights zero leaves the point undefined;
+ * like rational_bspline(), the origin is returned instead of NaN. The incremental sums
+ * of the cache drift, so "zero" has a small tolerance relative to the weights.
  */
-Point rationalBezier(WeightedPoint points[], int n, double t)
+Point projectHomogeneous(double num_x, double num_y, double denom)
 {
-  double num_x = 0.0, num_y = 0.0, denom = 0.0;
-
-  for (int i = 0; i < n; ++i)
-  {
-    double b = bernstein(i, n - 1, t);
-    num_x += points[i].weight * b * points[i].point.x;
-    num_y += points[i].weight * b * points[i].point.y;
-    denom += points[i].weight * b;
+  if (fabs(denom) < DENOMINATOR_EPSILON) {
+    Point origin = { 0.0, 0.0 };
+    return origin;
   }
-
   Point result = { num_x / denom, num_y / denom };
   return result;
 }
 
 /**
- * Update the weight of a point based on the slider position.
+ * Sampled curve with the sums behind it. The Bernstein values depend only on t, so they
+ * are computed once; the numerator and denominator sums are kept per sample so that a
+ * change of one control point only has to add the difference of its own term.
+ */
+typedef struct CurveCache
+{
+  double basis[N_POINTS_MAX][CURVE_STEPS + 1];
+  double num_x[CURVE_STEPS + 1];
+  double num_y[CURVE_STEPS + 1];
+  double denom[CURVE_STEPS + 1];
+  Point samples[CURVE_STEPS + 1];
+} CurveCache;
+
+/**
+ * Recompute every sample from scratch. Also used to drop the rounding drift of the
+ * incremental updates once a drag is over.
+ */
+void buildCurveCache(CurveCache* cache, WeightedPoint points[], int n)
+{
+  for (int s = 0; s <= CURVE_STEPS; ++s) {
+    double t = (double)s / CURVE_STEPS;
+    cache->num_x[s] = 0.0;
+    cache->num_y[s] = 0.0;
+    cache->denom[s] = 0.0;
+    for (int i = 0; i < n; ++i) {
+      double b = bernstein(i, n - 1, t);
+      cache->basis[i][s] = b;
+      cache->num_x[s] += points[i].weight * b * points[i].point.x;
+      cache->num_y[s] += points[i].weight * b * points[i].point.y;
+      cache->denom[s] += points[i].weight * b;
+    }
+    cache->samples[s] = projectHomogeneous(cache->num_x[s], cache->num_y[s], cache->denom[s]);
+  }
+}
+
+/**
+ * Replace control point i and its weight, adding only the change of term i to the sums.
+ */
+void updateCurveCache(CurveCache* cache, WeightedPoint points[], int i, Point point, double weight)
+{
+  double dx = weight * point.x - points[i].weight * points[i].point.x;
+  double dy = weight * point.y - points[i].weight * points[i].point.y;
+  double dw = weight - points[i].weight;
+  points[i].point = point;
+  points[i].weight = weight;
+  for (int s = 0; s <= CURVE_STEPS; ++s) {
+    double b = cache->basis[i][s];
+    cache->num_x[s] += dx * b;
+    cache->num_y[s] += dy * b;
+    cache->denom[s] += dw * b;
+    cache->samples[s] = projectHomogeneous(cache->num_x[s], cache->num_y[s], cache->denom[s]);
+  }
+}
+
+/**
+ * Weight belonging to a slider position.
  */
-void updateWeightFromClick(WeightedPoint* point, int mouse_x)
+double weightFromSlider(const WeightedPoint* point, int mouse_x)
 {
   double slider_min_x = point->point.x - WEIGHT_SLIDER_WIDTH / 2;
   double slider_max_x = point->point.x + WEIGHT_SLIDER_WIDTH / 2;
-  
+
   if (mouse_x < slider_min_x)
-    point->weight = 0.0;
-  else if (mouse_x > slider_max_x)
-    point->weight = MAX_WEIGHT;
-  else
-    point->weight = (mouse_x - slider_min_x) / WEIGHT_SLIDER_WIDTH * MAX_WEIGHT;
+    return 0.0;
+  if (mouse_x > slider_max_x)
+    return MAX_WEIGHT;
+  return (mouse_x - slider_min_x) / WEIGHT_SLIDER_WIDTH * MAX_WEIGHT;
+}
+
+/**
+ * Update the weight of a point based on the slider position.
+ */
+void updateWeightFromClick(CurveCache* cache, WeightedPoint points[], int i, int mouse_x)
+{
+  updateCurveCache(cache, points, i, points[i].point, weightFromSlider(&points[i], mouse_x));
 }
 
 /**
@@ -93,19 +153,13 @@ double distance(Point p1, Point p2)
 }
 
 /**
- * Approximate the length of the rational Bézier curve using numerical integration.
+ * Approximate the length of the rational Bézier curve as the length of the cached polyline.
  */
-double approximateCurveLength(WeightedPoint points[], int n)
+double approximateCurveLength(const CurveCache* cache)
 {
   double length = 0.0;
-  int steps = 100;  // Number of steps for the approximation
-  Point prev_point = rationalBezier(points, n, 0.0);
-
-  for (int i = 1; i <= steps; i++) {
-    double t = (double)i / steps;
-    Point curr_point = rationalBezier(points, n, t);
-    length += distance(prev_point, curr_point);
-    prev_point = curr_point;
+  for (int i = 1; i <= CURVE_STEPS; i++) {
+    length += distance(cache->samples[i - 1], cache->samples[i]);
   }
 
   return length;
@@ -126,6 +180,8 @@ int main(int argc, char* argv[])
   int i;
 
   WeightedPoint* selected_point = NULL;
+  int dragged_slider = -1;
+  static CurveCache cache;
   WeightedPoint points[N_POINTS];
   points[0].point.x = 200;
   points[0].point.y = 200;
@@ -152,6 +208,7 @@ int main(int argc, char* argv[])
     800, 600, 0);
 
   renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+  buildCurveCache(&cache, points, N_POINTS);
 
   double curve_length = 0.0;
   double last_curve_length = 0.0;
@@ -164,6 +221,7 @@ int main(int argc, char* argv[])
       case SDL_MOUSEBUTTONDOWN:
         SDL_GetMouseState(&mouse_x, &mouse_y);
         selected_point = NULL;
+        dragged_slider = -1;
         for (int i = 0; i < N_POINTS; ++i) {
           double dx = points[i].point.x - mouse_x;
           double dy = points[i].point.y - mouse_y;
@@ -172,23 +230,27 @@ int main(int argc, char* argv[])
             selected_point = points + i;
           }
 
-          // Check if the user clicks on a slider to update the weight
-          if (mouse_y > SLIDER_Y_OFFSET && mouse_y < SLIDER_Y_OFFSET + WEIGHT_SLIDER_HEIGHT) {
+          // Check if the user clicks on a slider; the first one hit keeps following the mouse
+          if (dragged_slider < 0 && mouse_y > SLIDER_Y_OFFSET && mouse_y < SLIDER_Y_OFFSET + WEIGHT_SLIDER_HEIGHT) {
             double slider_min_x = points[i].point.x - WEIGHT_SLIDER_WIDTH / 2;
             double slider_max_x = points[i].point.x + WEIGHT_SLIDER_WIDTH / 2;
 
             if (mouse_x >= slider_min_x && mouse_x <= slider_max_x) {
-              updateWeightFromClick(&points[i], mouse_x);
+              dragged_slider = i;
+              updateWeightFromClick(&cache, points, i, mouse_x);
               length_updated = true; // Mark that the length needs to be updated
             }
           }
         }
         break;
       case SDL_MOUSEMOTION:
-        if (selected_point != NULL) {
-          SDL_GetMouseState(&mouse_x, &mouse_y);
-          selected_point->point.x = mouse_x;
-          selected_point->point.y = mouse_y;
+        SDL_GetMouseState(&mouse_x, &mouse_y);
+        if (dragged_slider >= 0) {
+          updateWeightFromClick(&cache, points, dragged_slider, mouse_x);
+          length_updated = true;
+        } else if (selected_point != NULL) {
+          Point moved = { mouse_x, mouse_y };
+          updateCurveCache(&cache, points, (int)(selected_point - points), moved, selected_point->weight);
         }
         // Redraw
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
@@ -219,14 +281,13 @@ int main(int argc, char* argv[])
 
         // Draw the rational Bézier curve
         SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE);
-        for (double t = 0.0; t <= 1.0; t += 0.01) {
-          Point bezier_point = rationalBezier(points, N_POINTS, t);
-          SDL_RenderDrawPoint(renderer, (int)bezier_point.x, (int)bezier_point.y);
+        for (int s = 0; s <= CURVE_STEPS; ++s) {
+          SDL_RenderDrawPoint(renderer, (int)cache.samples[s].x, (int)cache.samples[s].y);
         }
 
         // Display the length if it was updated
         if (length_updated) {
-          curve_length = approximateCurveLength(points, N_POINTS);
+          curve_length = approximateCurveLength(&cache);
           if (curve_length != last_curve_length) {
             last_curve_length = curve_length;
             length_updated = false;  // Only update once
@@ -237,7 +298,11 @@ int main(int argc, char* argv[])
         SDL_RenderPresent(renderer);
         break;
       case SDL_MOUSEBUTTONUP:
+        if (selected_point != NULL || dragged_slider >= 0) {
+          buildCurveCache(&cache, points, N_POINTS);
+        }
         selected_point = NULL;
+        dragged_slider = -1;
         break;
       case SDL_KEYDOWN:
         if (event.key.keysym.sym == SDLK_q) {